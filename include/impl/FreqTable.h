@@ -0,0 +1,253 @@
+#ifndef FREQ_TABLE_H
+#define FREQ_TABLE_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "kits/utils.hpp"
+
+// Parametric frequency range, evaluated per index instead of materialized:
+//   start:stop:step      start, start + step, ... up to stop (inclusive when it lands on it)
+//   lin:start:stop:N     N points evenly spaced from start to stop
+//   log:start:stop:N     N points evenly spaced in log scale from start to stop (both > 0)
+struct FreqSweep {
+  enum class Kind { Step, Linear, Log };
+
+  Kind kind = Kind::Step;
+  double start = 0;
+  double stop = 0;
+  double step = 0; // Step only
+  size_t count = 0;
+  bool endsAtStop = false; // Step only: stop is a whole number of steps away and is the last point
+
+  static bool IsSweep(std::string_view spec) { return spec.find(':') != std::string_view::npos; }
+
+  static FreqSweep Parse(std::string_view spec) {
+    auto fields = CSVUtils::SplitRow(spec, ':');
+    FreqSweep sweep;
+    try {
+      if (fields.size() == 3) {
+        CSVUtils::ParseNumber(fields[0], sweep.start);
+        CSVUtils::ParseNumber(fields[1], sweep.stop);
+        CSVUtils::ParseNumber(fields[2], sweep.step);
+        CheckFinite(sweep);
+        double steps = (sweep.stop - sweep.start) / sweep.step;
+        if (sweep.step == 0 || !std::isfinite(steps) || steps < 0) {
+          throw std::runtime_error("step does not reach stop");
+        }
+        if (steps >= 1e15) {
+          throw std::runtime_error("too many points");
+        }
+        // Tolerate the rounding of the bounds, relative to their magnitude in steps, so a stop that is a
+        // whole number of steps away is included. A step that rounding alone could swallow is rejected.
+        double tolerance = 4 * std::numeric_limits<double>::epsilon() *
+                           std::max(std::abs(sweep.start), std::abs(sweep.stop)) / std::abs(sweep.step);
+        if (tolerance >= 0.5) {
+          throw std::runtime_error("step below the precision of the bounds");
+        }
+        sweep.count = static_cast<size_t>(std::floor(steps + tolerance)) + 1;
+        sweep.endsAtStop = std::abs(steps - static_cast<double>(sweep.count - 1)) <= tolerance;
+      } else if (fields.size() == 4 && (fields[0] == "lin" || fields[0] == "log")) {
+        sweep.kind = fields[0] == "lin" ? Kind::Linear : Kind::Log;
+        CSVUtils::ParseNumber(fields[1], sweep.start);
+        CSVUtils::ParseNumber(fields[2], sweep.stop);
+        CSVUtils::ParseNumber(fields[3], sweep.count);
+        CheckFinite(sweep);
+        if (sweep.count == 0 || (sweep.kind == Kind::Log && (sweep.start <= 0 || sweep.stop <= 0))) {
+          throw std::runtime_error("invalid point count or range");
+        }
+      } else {
+        throw std::runtime_error("unknown form");
+      }
+    } catch (const std::runtime_error &e) {
+      throw std::runtime_error("Invalid frequency sweep '" + std::string(spec) + "': " + e.what());
+    }
+    return sweep;
+  }
+
+  double At(size_t index) const {
+    switch (kind) {
+    case Kind::Step:
+      // the last point is stop itself rather than start + n * step, which can overshoot it by an ulp
+      return index + 1 == count && endsAtStop ? stop : start + static_cast<double>(index) * step;
+    case Kind::Linear:
+      if (count == 1 || index == 0) {
+        return start;
+      }
+      return index + 1 == count ? stop : start + (stop - start) * static_cast<double>(index) / (count - 1);
+    case Kind::Log:
+      if (count == 1 || index == 0) {
+        return start;
+      }
+      return index + 1 == count ? stop : start * std::pow(stop / start, static_cast<double>(index) / (count - 1));
+    }
+    return start;
+  }
+
+private:
+  static void CheckFinite(const FreqSweep &sweep) {
+    if (!std::isfinite(sweep.start) || !std::isfinite(sweep.stop) || !std::isfinite(sweep.step)) {
+      throw std::runtime_error("non-finite bound");
+    }
+  }
+};
+
+// One resolved frequency list. Immutable once published, so every stim using the list shares it. A
+// FreqListValue is either an explicit '|'-separated list or a single FreqSweep spec.
+struct FreqTable {
+  // fingerprint of the list text the values were parsed from, so Share can tell an unchanged list
+  uint64_t sourceHash = 0;
+  size_t sourceSize = 0;
+  std::vector<double> values; // explicit lists only
+  std::optional<FreqSweep> sweep;
+
+  static FreqTable Parse(std::string_view text) {
+    FreqTable table;
+    table.sourceHash = CSVUtils::HashBytes(text);
+    table.sourceSize = text.size();
+    if (FreqSweep::IsSweep(text)) {
+      table.sweep = FreqSweep::Parse(text);
+    } else {
+      table.values = CSVUtils::ParseNumericList<double>(text, '|');
+    }
+    return table;
+  }
+
+  bool IsParsedFrom(std::string_view text) const {
+    return text.size() == sourceSize && CSVUtils::HashBytes(text) == sourceHash;
+  }
+  size_t size() const { return sweep ? sweep->count : values.size(); }
+  bool empty() const { return size() == 0; }
+  // no range checks, see FreqAt and GatherFreqs
+  double At(size_t index) const { return sweep ? sweep->At(index) : values[index]; }
+  void Gather(std::span<const size_t> indexs, std::span<double> out) const;
+};
+
+using FreqTablePtr = std::shared_ptr<const FreqTable>;
+
+// Checked lookups on a resolved list that may be missing.
+inline double FreqAt(const FreqTable *table, size_t index) {
+  if (!table || index >= table->size()) {
+    throw std::runtime_error("Index out of range.");
+  }
+  return table->At(index);
+}
+// Bulk FreqAt: the whole index set is checked once, then out[i] = frequency of indexs[i].
+inline void GatherFreqs(const FreqTable *table, std::span<const size_t> indexs, std::span<double> out) {
+  if (indexs.empty()) {
+    return;
+  }
+  if (out.size() < indexs.size()) {
+    throw std::runtime_error("Output span too small.");
+  }
+  if (!table || *std::max_element(indexs.begin(), indexs.end()) >= table->size()) {
+    throw std::runtime_error("Index out of range.");
+  }
+  table->Gather(indexs, out.first(indexs.size()));
+}
+
+// Process-wide cache of resolved lists, keyed by flist file and list name, in front of the flist
+// configurator: resolving a list that is cached is a hash lookup. A file's entries are dropped whenever
+// RFConfigManager publishes a new table for it, and a result resolved from a table that was replaced
+// meanwhile is handed out but not cached.
+class FreqTableRegistry {
+public:
+  static FreqTableRegistry &GetInstance() {
+    static FreqTableRegistry instance;
+    return instance;
+  }
+
+  // Cached table, or the list queried from the file's current table and cached.
+  FreqTablePtr Resolve(const std::string &file, const std::string &name) {
+    uint64_t generation;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      auto &entry = mFiles[file];
+      if (auto it = entry.tables.find(name); it != entry.tables.end()) {
+        return it->second;
+      }
+      generation = entry.generation;
+    }
+    QuerySequence sequence{name};
+    RFConfigManager::GetInstance().OnQuery(file, sequence);
+    if (sequence.queryResult.empty()) {
+      throw std::runtime_error("Not Found Such FreqListName: " + name);
+    }
+    return Share(file, name, sequence.queryResult[1], generation);
+  }
+
+  // Cached table when it holds exactly `values`, otherwise `values` parsed. The result is cached only
+  // when it was read at `generation` (see GetGeneration) and the file did not change since.
+  FreqTablePtr Share(const std::string &file, const std::string &name, std::string_view values,
+                     uint64_t generation = kUnknownGeneration) {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (auto table = FindLocked(file, name); table && table->IsParsedFrom(values)) {
+        return table;
+      }
+    }
+    // parse outside the lock
+    auto parsed = std::make_shared<const FreqTable>(FreqTable::Parse(values));
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto &entry = mFiles[file];
+    if (generation == entry.generation) {
+      entry.tables[name] = parsed;
+    }
+    return parsed;
+  }
+
+  FreqTablePtr Find(const std::string &file, const std::string &name) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return FindLocked(file, name);
+  }
+
+  uint64_t GetGeneration(const std::string &file) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFiles[file].generation;
+  }
+
+  void Invalidate(const std::string &file) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto &entry = mFiles[file];
+    entry.tables.clear();
+    ++entry.generation;
+  }
+
+private:
+  static constexpr uint64_t kUnknownGeneration = UINT64_MAX;
+
+  struct FileEntry {
+    uint64_t generation = 0;
+    std::unordered_map<std::string, FreqTablePtr> tables;
+  };
+
+  FreqTableRegistry()
+      : mSubscription(RFConfigManager::GetInstance().SubscribeConfigChange(
+            [this](const std::string &config) { Invalidate(config); })) {}
+  ~FreqTableRegistry() { RFConfigManager::GetInstance().UnsubscribeConfigChange(mSubscription); }
+  FreqTableRegistry(const FreqTableRegistry &) = delete;
+  FreqTableRegistry &operator=(const FreqTableRegistry &) = delete;
+
+  FreqTablePtr FindLocked(const std::string &file, const std::string &name) const {
+    auto entry = mFiles.find(file);
+    if (entry == mFiles.end()) {
+      return nullptr;
+    }
+    auto it = entry->second.tables.find(name);
+    return it == entry->second.tables.end() ? nullptr : it->second;
+  }
+
+  std::mutex mMutex;
+  std::unordered_map<std::string, FileEntry> mFiles;
+  size_t mSubscription;
+};
+
+#endif // FREQ_TABLE_H
@@ -1,21 +1,98 @@
 #ifndef RF_CONFIG_MANAGER_H
 #define RF_CONFIG_MANAGER_H
 
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
-enum class EventType { CONFIG_LOAD, CONFIG_QUERY };
+#include "kits/csvparser.hpp"
+#include "kits/intern.hpp"
+#include "kits/rcu.hpp"
+
+enum class EventType { CONFIG_LOAD, CONFIG_QUERY, CONFIG_RELOAD };
+
+// Eager: OnLoad must run before a config is queried. Lazy: a config is parsed by its first query.
+enum class LoadPolicy { Eager, Lazy };
 
 struct QuerySequence {
+  QuerySequence() = default;
+  QuerySequence(std::string command, std::vector<std::string_view> result = {})
+      : queryCommand(std::move(command)), queryResult(std::move(result)) {}
+
   std::string queryCommand;
   std::vector<std::string_view> queryResult;
+  // keeps the table snapshot queryResult points into alive, even across a reload of that config
+  std::shared_ptr<const void> queryOwner;
+  // when set, the fields are also returned as handles interned in the snapshot's arena
+  bool internResult{false};
+  std::vector<InternedString> queryInterned;
+};
+
+// Rows for many keys of one config, resolved against a single table snapshot. Row i is found when
+// rows[i] != npos; its fields are fields[i * width, (i + 1) * width) and stay valid while owner lives.
+struct BatchQueryResult {
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  size_t width = 0;
+  std::vector<size_t> rows;
+  std::vector<std::string_view> fields;
+  std::shared_ptr<const void> owner;
+  // set before the call to also get the fields interned in the snapshot's arena, same layout as fields
+  bool intern = false;
+  std::vector<InternedString> interned;
+
+  size_t size() const noexcept { return rows.size(); }
+  bool IsFound(size_t i) const noexcept { return rows[i] != npos; }
+  std::span<const std::string_view> Row(size_t i) const {
+    return IsFound(i) ? std::span<const std::string_view>(fields).subspan(i * width, width)
+                      : std::span<const std::string_view>();
+  }
+};
+
+// Row keys touched by reloading one config file.
+struct ConfigReload {
+  std::string config;
+  std::vector<std::string> added;
+  std::vector<std::string> removed;
+  std::vector<std::string> changed;
+};
+
+// Load and query figures of one config, see RFConfigManager::GetStats.
+struct ConfigStats {
+  std::string config;
+  bool loaded = false;
+  ParseStats parse;                 // phases of the table currently served
+  std::chrono::nanoseconds load{0}; // last load or reload end to end, snapshot refresh included
+  uint64_t loads = 0;
+  uint64_t reloads = 0;
+  uint64_t queries = 0; // single, batch and predicate queries; a batch counts once
+  std::chrono::nanoseconds queryTotal{0};
+  std::chrono::nanoseconds queryMax{0};
 };
 
+enum class StatsFormat { Text, Json };
+
 class EventListener;
-class CSVParser;
+
+// One published load of a config: the parsed table plus the arena interning strings taken from it.
+// Both live until the last query result holding this snapshot is gone.
+struct ConfigTable {
+  explicit ConfigTable(std::shared_ptr<const CSVParser> table) : parser(std::move(table)) {}
+
+  std::shared_ptr<const CSVParser> parser;
+  mutable StringArena arena;
+};
 
 using EventListenerPtr = std::shared_ptr<EventListener>;
 using EventListenerWrpper = std::function<EventListenerPtr(const std::string &)>;
@@ -23,6 +100,17 @@ using EventListenerWrpper = std::function<EventListenerPtr(const std::string &)>
 class EventListener {
 public:
   virtual void HandleEvent(EventType type, QuerySequence &query) = 0;
+  virtual void HandleBatchQuery(std::span<const std::string> keys, BatchQueryResult &result) {
+    (void)keys;
+    (void)result;
+    throw std::runtime_error("EventListener::HandleBatchQuery: Batch query not supported");
+  }
+  // Rows matching a predicate query, laid out like a batch query result whose rows[i] are row ids.
+  virtual void HandleSelect(const RowQuery &query, BatchQueryResult &result) {
+    (void)query;
+    (void)result;
+    throw std::runtime_error("EventListener::HandleSelect: Predicate query not supported");
+  }
   virtual ~EventListener() = default;
 };
 
@@ -31,15 +119,50 @@ public:
   explicit ConfiguratorListener(const std::string &configFilePath);
   ~ConfiguratorListener();
   virtual void HandleEvent(EventType type, QuerySequence &query) override;
+  virtual void HandleBatchQuery(std::span<const std::string> keys, BatchQueryResult &result) override;
+  virtual void HandleSelect(const RowQuery &query, BatchQueryResult &result) override;
+  // Result of the last CONFIG_RELOAD event; empty when the file had not changed.
+  const std::optional<ConfigReload> &GetLastReload() const { return m_last_reload; }
+  void SetLazyLoad(bool lazy) { m_lazy_load = lazy; }
+  // Loads the file unless it already is; safe to race with queries and other loads. With wait = false
+  // it returns at once when another thread is loading the file already.
+  void EnsureLoaded(bool wait = true);
+  ConfigStats GetStats() const;
+  // Called with the config name after every load or reload published a new table, from the loading
+  // thread. Set before the listener is shared.
+  void SetTableChangedCallback(std::function<void(const std::string &)> callback) {
+    m_on_table_changed = std::move(callback);
+  }
 
 protected:
   std::string m_config;
+  // configuration only (columns, projection, modes); every load parses into a clone of it
   std::shared_ptr<CSVParser> m_parser_proxy = nullptr;
-  bool isConfigLoaded{false};
+  // columns commonly filtered on; every loaded table gets a secondary index on them
+  std::vector<std::string> m_indexed_columns;
+  // published table, replaced as a whole by load and reload; queries only read it
+  RcuPtr<ConfigTable> m_table;
+  std::atomic<bool> isConfigLoaded{false};
+  std::atomic<bool> m_lazy_load{false};
+  std::mutex m_load_mutex; // serializes load and reload; loaded queries do not take it
+  // thread running the load or reload, so code called back from it does not wait on its own lock
+  std::atomic<std::thread::id> m_loading_thread{};
+  std::optional<ConfigReload> m_last_reload;
+  std::function<void(const std::string &)> m_on_table_changed;
+  // counters are updated by concurrent queries, hence atomics rather than a ConfigStats
+  std::atomic<int64_t> m_load_nanos{0};
+  std::atomic<uint64_t> m_load_count{0};
+  std::atomic<uint64_t> m_reload_count{0};
+  std::atomic<uint64_t> m_query_count{0};
+  std::atomic<int64_t> m_query_nanos{0};
+  std::atomic<int64_t> m_query_max_nanos{0};
 
 private:
+  template <typename F> void RunAsLoader(F &&load); // caller holds m_load_mutex
   void OnLoadEvent(const std::string &filename);
   void OnQueryEvent(QuerySequence &query);
+  void OnReloadEvent();
+  void RecordQuery(std::chrono::steady_clock::time_point start);
   void SetConfigLoadStatus(bool status);
   bool IsConfigLoaded() const { return isConfigLoaded; }
   void Cleanup();
@@ -59,7 +182,10 @@ public:
 };
 
 using EventListenerMap = std::unordered_map<std::string, EventListenerPtr>;
+using EventListenerMapPtr = std::shared_ptr<const EventListenerMap>;
 
+// Listeners are published RCU-style: readers take the current immutable map without locking, writers
+// copy it, modify the copy and swap it in.
 class EventPublisher {
 public:
   void AddListener(const std::string &config, const EventListenerPtr &listener);
@@ -67,12 +193,17 @@ public:
   void RemoveAll();
   void NotifyOne(const std::string &config, EventType type, QuerySequence &maybeUsed);
   void NotifyAll(EventType type, QuerySequence &maybeUsed);
-  EventListenerMap GeActivetListeners() const { return mActiveListeners; }
+  EventListenerMapPtr GeActivetListeners() const { return mActiveListeners.Load(); }
 
 private:
-  EventListenerMap mActiveListeners;
+  template <typename F> void Update(F &&modify);
+
+  RcuPtr<EventListenerMap> mActiveListeners{std::make_shared<const EventListenerMap>()};
+  std::mutex mWriteMutex;
 };
 
+// Queries (OnQuery, Prefetch) may run from any number of threads and never wait for a load or reload of
+// a loaded config. Setup, creation, OnLoad and ReloadChanged are expected from one thread at a time.
 class RFConfigManager {
 public:
   static RFConfigManager &GetInstance();
@@ -81,17 +212,69 @@ public:
   void DestoryConfiguratorFactory();
   void CreateConfigurator(const std::string &config);
   void CreateConfigurators(const std::vector<std::string> &configs);
+  // Loading a config that is loaded already does nothing; ReloadChanged picks up edited files.
   void OnLoad(const std::string &config);
+  // Loads every configurator concurrently, level by level so a config loads after the ones it depends on
+  // (.stim/.meas after .flist). Every failure is collected and reported in one exception.
   void OnLoad();
   void OnQuery(const std::string &config, QuerySequence &maybeUsed);
+  // One listener lookup and one snapshot for all keys; missing keys are reported per row, not thrown.
+  void OnBatchQuery(const std::string &config, std::span<const std::string> keys, BatchQueryResult &result);
+  // All rows of a config matching every predicate, in row order, against a single snapshot.
+  void OnSelect(const std::string &config, const RowQuery &query, BatchQueryResult &result);
+
+  // Lazy policy: configs are parsed on their first OnQuery instead of requiring OnLoad up front.
+  // Applies to existing and future configurators.
+  void SetLoadPolicy(LoadPolicy policy);
+  LoadPolicy GetLoadPolicy() const { return mLoadPolicy; }
+  // Hint that a config will be queried soon: it is loaded in the background unless it already is.
+  // The future reports the load error, if any; a later query retries the load on its own.
+  std::future<void> Prefetch(const std::string &config);
+  void Prefetch(const std::vector<std::string> &configs);
   std::string GetConfigFileByExtension(const std::string &ext);
 
+  // Per-config parse phases, load times and query latency, ordered by config name. DumpStats renders
+  // them as one line per config, or as a JSON document with all durations in nanoseconds.
+  std::vector<ConfigStats> GetStats();
+  std::string DumpStats(StatsFormat format = StatsFormat::Text);
+
+  // Observers of configs whose table was replaced (load, reload) or that are about to be dropped, for
+  // invalidating whatever was derived from them. They run on the thread that loaded the config.
+  using ConfigChangeCallback = std::function<void(const std::string &config)>;
+  size_t SubscribeConfigChange(ConfigChangeCallback callback);
+  void UnsubscribeConfigChange(size_t id);
+
+  // Hot reload. EnableHotReload watches the directories of the created configs (inotify on Linux);
+  // ReloadChanged re-parses only the files modified since their last load and returns their row diffs.
+  // Without inotify ReloadChanged falls back to comparing every file's size and mtime. Tables always
+  // own a copy of their file's text, so editing a file in place never changes a published table.
+  void EnableHotReload();
+  void DisableHotReload();
+  std::vector<ConfigReload> ReloadChanged();
+
 protected:
   EventListenerPtr CreateConfiguratorImpl(const std::string &config);
   EventPublisher mPublisher;
   std::unordered_map<std::string, EventListenerWrpper> mConfiguratorFactory;
+  // extension -> extensions it refers to, which have to be loaded first
+  std::unordered_map<std::string, std::vector<std::string>> mConfiguratorDependencies;
 
 private:
+  std::vector<std::vector<std::string>> GetLoadLevels();
+  void WatchConfig(const std::string &config);
+  std::vector<std::string> CollectChangedConfigs();
+  void NotifyConfigChange(const std::string &config);
+
+  LoadPolicy mLoadPolicy{LoadPolicy::Eager};
+  int mWatchFd{-1};
+  bool mWatchOverflow{false};
+  std::vector<std::string> mRetryReload; // failed last time, checked again on the next ReloadChanged
+  // watch descriptor -> file name in that directory -> config
+  std::unordered_map<int, std::unordered_map<std::string, std::string>> mWatches;
+  std::mutex mObserverMutex;
+  std::vector<std::pair<size_t, ConfigChangeCallback>> mObservers;
+  size_t mNextObserver{0};
+
   RFConfigManager();
   ~RFConfigManager();
   RFConfigManager(const RFConfigManager &) = delete;
@@ -2,84 +2,136 @@
 #define STIM_DEF_INNER_H
 
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
-#include "impl/FreqListInner.h"
+#include "impl/FreqTable.h"
+#include "impl/StimTable.h"
 #include "kits/utils.hpp"
 
+// Snapshot of one stim's definition. Name-like fields are handles into the owning StimTable's dictionary
+// and stay valid as long as the table lives.
 struct StimConfiguration {
-  std::string stimName;
-  std::string stimType;
-  std::string triggerType;
-  std::string pinName;
-  std::string freqListName;
+  InternedString stimName;
+  InternedString stimType;
+  InternedString triggerType;
+  InternedString pinName;
+  InternedString freqListName;
   std::vector<size_t> freqListIndexs;
   std::vector<double> freqs;
   std::vector<double> powers;
   size_t repeatCount = 0;
-  std::string waveFile;
+  InternedString waveFile;
 };
 
+// Handle to one row of a StimTable. Definitions that do not come with a table get a table of their own.
 class StimDefInner {
 public:
+  using Field = StimTable::Field;
+
   explicit StimDefInner(const std::vector<std::string> &stimDefs)
-      : mStimDefs(stimDefs), mFreqList(std::make_shared<FreqListInner>(stimDefs.at(4), stimDefs.at(5))) {
-    mStimConfig.stimName = stimDefs.at(0);
-    mStimConfig.stimType = stimDefs.at(1);
-    mStimConfig.triggerType = stimDefs.at(2);
-    mStimConfig.pinName = stimDefs.at(3);
-    mStimConfig.freqListName = mFreqList->GetFreqListName();
-    mStimConfig.freqListIndexs = mFreqList->GetFreqListIndexs();
-    mStimConfig.powers = ParsePowers(stimDefs.at(6));
-    mStimConfig.waveFile = stimDefs.at(7);
-    mStimConfig.repeatCount = std::stoll(stimDefs.at(8));
-  }
-  ~StimDefInner() { Cleanup(); }
+      : StimDefInner(std::make_shared<StimTable>(), stimDefs) {}
+  explicit StimDefInner(const InternedRow &stimDefs) : StimDefInner(std::make_shared<StimTable>(), stimDefs) {}
+  // Appends the definition to a table shared with other stims.
+  StimDefInner(std::shared_ptr<StimTable> table, const std::vector<std::string> &stimDefs)
+      : mTable(std::move(table)), mRow(mTable->Append(stimDefs)) {}
+  StimDefInner(std::shared_ptr<StimTable> table, const InternedRow &stimDefs)
+      : mTable(std::move(table)), mRow(mTable->Append(stimDefs.fields)) {}
+  // Fields viewing a query result; the table interns its own copy.
+  StimDefInner(std::shared_ptr<StimTable> table, std::span<const std::string_view> stimDefs)
+      : mTable(std::move(table)), mRow(mTable->Append(stimDefs)) {}
 
   void SetFreqListFile(const std::string &file) {
     if (file.empty()) {
       throw std::runtime_error("Invalid FreqList file.");
     }
-    mFreqList->SetFreqListFile(file);
+    mTable->SetFreqListFile(mRow, file);
+  }
+  void SetFreqListIndex(size_t index) {
+    mTable->SetFreqListIndexs(mRow, std::span<const size_t>(&index, 1));
+    mFreqsStale = true;
+  }
+  void SetFreqListIndex(const std::vector<size_t> &indexs) {
+    mTable->SetFreqListIndexs(mRow, indexs);
+    mFreqsStale = true;
   }
-  void SetFreqListIndex(size_t index) { mFreqList->UpdateFreqListIndex(index); }
-  void SetFreqListIndex(const std::vector<size_t> &indexs) { mFreqList->UpdateFreqListIndex(indexs); }
   void UpdateFreqListValuesByName(const std::string &name) {
-    mFreqList->SetFreqListName(name);
-    mFreqList->UpdateFreqListValues();
+    auto table = FreqTableRegistry::GetInstance().Resolve(FreqListFile(), name);
+    mTable->SetFreqListName(mRow, name);
+    SetFreqTable(std::move(table));
   }
-  std::string FreqListFile() const { return mFreqList->GetFreqListFile(); }
-  std::string FreqListName() const { return mStimConfig.freqListName; }
-  std::string StimName() const { return mStimConfig.stimName; }
-  std::string Pin() const { return mStimConfig.pinName; }
-  std::string Type() const { return mStimConfig.stimType; }
-  std::string WaveFile() const { return mStimConfig.waveFile; }
-  std::vector<double> Power() const { return mStimConfig.powers; }
-  std::vector<size_t> FreqListIndex() const { return mStimConfig.freqListIndexs; }
-  double Frequency() const { return mFreqList->GetFreqByIndex(mStimConfig.freqListIndexs[0]); }
-  std::vector<double> Frequencies() const { return mFreqList->GetFreqsByIndexs(mStimConfig.freqListIndexs); }
-  double GetFrequencyByIndex(size_t index) { return mFreqList->GetFreqByIndex(index); }
-  std::vector<double> GetFrequencyListByIndex(const std::vector<size_t> &indexs) {
-    return mFreqList->GetFreqsByIndexs(indexs);
+  void SetFreqListValues(std::string_view values) {
+    SetFreqTable(FreqTableRegistry::GetInstance().Share(FreqListFile(), FreqListName(), values));
+  }
+  bool HasFreqListValues() const { return GetFreqTable() && !GetFreqTable()->empty(); }
+  void SetFreqTable(FreqTablePtr table) {
+    mTable->SetFreqTable(mRow, std::move(table));
+    mFreqsStale = true;
+  }
+  const FreqTablePtr &GetFreqTable() const { return mTable->GetFreqTable(mRow); }
+  std::string FreqListFile() const { return mTable->Get(mRow, Field::FreqListFile).Str(); }
+  std::string FreqListName() const { return mTable->Get(mRow, Field::FreqListName).Str(); }
+  std::string StimName() const { return mTable->Get(mRow, Field::Name).Str(); }
+  std::string Pin() const { return mTable->Get(mRow, Field::Pin).Str(); }
+  std::string Type() const { return mTable->Get(mRow, Field::Type).Str(); }
+  std::string WaveFile() const { return mTable->Get(mRow, Field::WaveFile).Str(); }
+  StimConfiguration GetConfiguration() const {
+    auto indexs = mTable->FreqListIndexs(mRow);
+    auto powers = mTable->Powers(mRow);
+    return StimConfiguration{mTable->Get(mRow, Field::Name),
+                             mTable->Get(mRow, Field::Type),
+                             mTable->Get(mRow, Field::Trigger),
+                             mTable->Get(mRow, Field::Pin),
+                             mTable->Get(mRow, Field::FreqListName),
+                             {indexs.begin(), indexs.end()},
+                             {},
+                             {powers.begin(), powers.end()},
+                             mTable->RepeatCount(mRow),
+                             mTable->Get(mRow, Field::WaveFile)};
+  }
+  // Views into the table, see StimTable::Powers and StimTable::FreqListIndexs.
+  std::span<const double> Power() const { return mTable->Powers(mRow); }
+  std::span<const size_t> FreqListIndex() const { return mTable->FreqListIndexs(mRow); }
+  double Frequency() const { return GetFrequencyByIndex(mTable->FreqListIndexs(mRow)[0]); }
+  // Gathered on first use after the list or the indexes changed; the reference stays valid until then.
+  // Not synchronized, like the setters: a stim is used from one thread at a time.
+  const std::vector<double> &Frequencies() {
+    if (mFreqsStale) {
+      auto indexs = mTable->FreqListIndexs(mRow);
+      mFreqs.resize(indexs.size());
+      GatherFreqs(GetFreqTable().get(), indexs, mFreqs);
+      mFreqsStale = false;
+    }
+    return mFreqs;
+  }
+  double GetFrequencyByIndex(size_t index) const { return FreqAt(GetFreqTable().get(), index); }
+  void GetFrequencyListByIndex(std::span<const size_t> indexs, std::span<double> out) const {
+    GatherFreqs(GetFreqTable().get(), indexs, out);
+  }
+  std::vector<double> GetFrequencyListByIndex(std::span<const size_t> indexs) const {
+    std::vector<double> freqs(indexs.size());
+    GetFrequencyListByIndex(indexs, freqs);
+    return freqs;
   }
 
-  std::vector<std::string> GetStimDefs() const { return mStimDefs; }
-
-protected:
-  void Cleanup() { mFreqList->Cleanup(); }
-  std::vector<double> ParsePowers(const std::string &power) {
-    auto power_tokens = RFUTILS::DoSplit(power, '|');
-    std::vector<double> powers(power_tokens.size());
-    std::transform(power_tokens.begin(), power_tokens.end(), std::back_inserter(powers),
-                   [](auto &token) { return std::stod(token); });
-    return powers;
+  // Stim file fields exactly as the definition gave them; setters do not change them.
+  std::vector<std::string> GetStimDefs() const {
+    std::vector<std::string> stimDefs;
+    for (const auto &field : mTable->GetDefinition(mRow)) {
+      stimDefs.push_back(field.Str());
+    }
+    return stimDefs;
   }
 
+  const std::shared_ptr<StimTable> &GetTable() const { return mTable; }
+  StimTable::Row GetRow() const { return mRow; }
+
 private:
-  std::vector<std::string> mStimDefs;
-  StimConfiguration mStimConfig;
-  std::shared_ptr<FreqListInner> mFreqList = nullptr;
+  std::shared_ptr<StimTable> mTable;
+  StimTable::Row mRow;
+  std::vector<double> mFreqs; // Frequencies() cache
+  bool mFreqsStale = true;
 };
 
 #endif
\ No newline at end of file
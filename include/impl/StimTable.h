@@ -0,0 +1,266 @@
+#ifndef STIM_TABLE_H
+#define STIM_TABLE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "impl/FreqTable.h"
+#include "kits/intern.hpp"
+
+// Struct-of-arrays store for stim definitions: one slot per stim in each column instead of one object per
+// stim. Name-like fields are ids into the table's own intern dictionary, so every distinct name is held
+// once and a scan over one field (e.g. all stims on a pin) walks a packed id array. Powers, freq list
+// indexes and the ids of every row's original fields live in shared block arrays that rows address by
+// slice; blocks never move, so views into them last as long as the table. Appends and setters are not
+// synchronized; a table belongs to one NRFStim.
+class StimTable {
+public:
+  using Row = uint32_t;
+  enum class Field { Name, Type, Trigger, Pin, FreqListName, WaveFile, FreqListFile };
+
+  StimTable() : m_arena(std::make_shared<StringArena>()) {}
+  StimTable(const StimTable &) = delete;
+  StimTable &operator=(const StimTable &) = delete;
+
+  // Appends one stim file row: name, type, trigger, pin, freq list name, freq list indexes, powers, wave
+  // file and an optional repeat count. Fields are anything convertible to std::string_view. Everything is
+  // parsed and room is made before the first column changes, so a row that fails leaves the table as it
+  // was (at most it holds a few unused strings or an empty block).
+  template <typename Fields> Row Append(const Fields &stimDefs) {
+    if (stimDefs.size() < 8) {
+      throw std::runtime_error("Invalid stim definition.");
+    }
+    if (size() >= kMaxRow) {
+      throw std::runtime_error("Stim table is full.");
+    }
+    auto field = [&](size_t i) { return std::string_view(stimDefs[i]); };
+    size_t repeat = 0;
+    // the stim file has no repeat column yet; rows without one repeat 0 times
+    if (stimDefs.size() > 8) {
+      CSVUtils::ParseNumber(field(8), repeat);
+    }
+    auto indexs = CSVUtils::ParseNumericList<size_t>(field(5), '|');
+    auto powers = CSVUtils::ParseNumericList<double>(field(6), '|');
+    std::vector<uint32_t> fields(stimDefs.size());
+    for (size_t i = 0; i < fields.size(); ++i) {
+      fields[i] = Intern(field(i));
+    }
+    const uint32_t ids[] = {fields[0], fields[1], fields[2], fields[3], fields[4], fields[7], Intern({})};
+
+    for (auto *column : {&m_names, &m_types, &m_triggers, &m_pins, &m_freq_list_names, &m_wave_files,
+                         &m_freq_list_files}) {
+      Reserve(*column, 1);
+    }
+    Reserve(m_index_slices, 1);
+    Reserve(m_power_slices, 1);
+    Reserve(m_field_slices, 1);
+    Reserve(m_repeat_counts, 1);
+    Reserve(m_freq_tables, 1);
+    m_indexs.Reserve(indexs.size());
+    m_powers.Reserve(powers.size());
+    m_fields.Reserve(fields.size());
+
+    // nothing below allocates or throws
+    m_index_slices.push_back(m_indexs.Place(indexs));
+    m_power_slices.push_back(m_powers.Place(powers));
+    m_field_slices.push_back(m_fields.Place(fields));
+    m_names.push_back(ids[0]);
+    m_types.push_back(ids[1]);
+    m_triggers.push_back(ids[2]);
+    m_pins.push_back(ids[3]);
+    m_freq_list_names.push_back(ids[4]);
+    m_wave_files.push_back(ids[5]);
+    m_freq_list_files.push_back(ids[6]);
+    m_repeat_counts.push_back(repeat);
+    m_freq_tables.emplace_back();
+    return static_cast<Row>(size() - 1);
+  }
+
+  size_t size() const noexcept { return m_names.size(); }
+
+  InternedString Get(Row row, Field field) const { return m_strings[Column(field)[row]]; }
+  // The stim file fields exactly as appended; setters do not change them.
+  std::vector<InternedString> GetDefinition(Row row) const {
+    std::vector<InternedString> fields;
+    for (auto id : m_fields.View(m_field_slices[row])) {
+      fields.push_back(m_strings[id]);
+    }
+    return fields;
+  }
+  // Valid as long as the table; SetFreqListIndexs on the same row may change what they show.
+  std::span<const size_t> FreqListIndexs(Row row) const { return m_indexs.View(m_index_slices[row]); }
+  std::span<const double> Powers(Row row) const { return m_powers.View(m_power_slices[row]); }
+  size_t RepeatCount(Row row) const { return m_repeat_counts[row]; }
+  const FreqTablePtr &GetFreqTable(Row row) const { return m_freq_tables[row]; }
+
+  void SetFreqListFile(Row row, std::string_view file) { m_freq_list_files[row] = Intern(file); }
+  void SetFreqListName(Row row, std::string_view name) { m_freq_list_names[row] = Intern(name); }
+  void SetFreqTable(Row row, FreqTablePtr table) { m_freq_tables[row] = std::move(table); }
+  // Overwritten in place when the new list is no longer than the old one; otherwise the list moves to
+  // fresh slots and the old ones stay unused. indexs may view this table.
+  void SetFreqListIndexs(Row row, std::span<const size_t> indexs) {
+    auto &slice = m_index_slices[row];
+    if (indexs.size() <= slice.size) {
+      if (!indexs.empty()) {
+        std::memmove(m_indexs.Data(slice), indexs.data(), indexs.size() * sizeof(size_t));
+      }
+      slice.size = static_cast<uint32_t>(indexs.size());
+      return;
+    }
+    m_indexs.Reserve(indexs.size()); // existing blocks stay put, so indexs survives this
+    slice = m_indexs.Place(indexs);
+  }
+
+  // Rows whose field equals value, ascending.
+  std::vector<Row> FindRows(Field field, std::string_view value) const {
+    std::vector<Row> rows;
+    auto handle = m_arena->Find(value);
+    if (!handle.IsValid()) {
+      return rows;
+    }
+    const auto &column = Column(field);
+    for (size_t row = 0; row < column.size(); ++row) {
+      if (column[row] == handle.Id()) {
+        rows.push_back(static_cast<Row>(row));
+      }
+    }
+    return rows;
+  }
+
+  // Bytes held by the columns and the dictionary text.
+  size_t GetByteSize() const {
+    return (m_names.capacity() + m_types.capacity() + m_triggers.capacity() + m_pins.capacity() +
+            m_freq_list_names.capacity() + m_wave_files.capacity() + m_freq_list_files.capacity()) *
+               sizeof(uint32_t) +
+           (m_index_slices.capacity() + m_power_slices.capacity() + m_field_slices.capacity()) * sizeof(Slice) +
+           m_indexs.GetByteSize() + m_powers.GetByteSize() + m_fields.GetByteSize() +
+           m_repeat_counts.capacity() * sizeof(size_t) + m_freq_tables.capacity() * sizeof(FreqTablePtr) +
+           m_strings.capacity() * sizeof(InternedString) + m_arena->GetByteSize();
+  }
+
+private:
+  static constexpr size_t kMaxRow = UINT32_MAX;
+
+  struct Slice {
+    uint32_t block = 0;
+    uint32_t begin = 0;
+    uint32_t size = 0;
+  };
+
+  // Append-only runs of values in blocks that are never moved or freed before the table, so a view of a
+  // run survives later appends. A run longer than a block gets a block of its own.
+  template <typename T> class BlockArray {
+  public:
+    // Makes room for a run of count values, so the next Place does not allocate.
+    void Reserve(size_t count) {
+      if (!m_blocks.empty() && m_blocks.back().capacity - m_used >= count) {
+        return;
+      }
+      if (count > kMaxRow || m_blocks.size() >= kMaxRow) {
+        throw std::runtime_error("Stim table is full.");
+      }
+      StimTable::Reserve(m_blocks, 1);
+      size_t capacity = std::max(kBlockSize, count);
+      m_blocks.push_back(Block{std::make_unique<T[]>(capacity), capacity});
+      m_used = 0;
+    }
+    // Copies values into the room made by Reserve(values.size()); does not throw.
+    Slice Place(std::span<const T> values) noexcept {
+      if (values.empty()) {
+        return Slice{};
+      }
+      Slice slice{static_cast<uint32_t>(m_blocks.size() - 1), static_cast<uint32_t>(m_used),
+                  static_cast<uint32_t>(values.size())};
+      std::copy(values.begin(), values.end(), m_blocks.back().values.get() + m_used);
+      m_used += values.size();
+      return slice;
+    }
+    std::span<const T> View(Slice slice) const {
+      return slice.size == 0 ? std::span<const T>() : std::span<const T>(Data(slice), slice.size);
+    }
+    T *Data(Slice slice) const { return m_blocks[slice.block].values.get() + slice.begin; }
+    size_t GetByteSize() const {
+      size_t bytes = m_blocks.capacity() * sizeof(Block);
+      for (const auto &block : m_blocks) {
+        bytes += block.capacity * sizeof(T);
+      }
+      return bytes;
+    }
+
+  private:
+    static constexpr size_t kBlockSize = 4096;
+
+    struct Block {
+      std::unique_ptr<T[]> values;
+      size_t capacity = 0;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_used = 0; // values taken in the last block
+  };
+
+  // The arena is private to the table, so its ids count up from 0 and double as dictionary positions.
+  uint32_t Intern(std::string_view text) {
+    Reserve(m_strings, 1); // a new id must always find its dictionary slot
+    auto handle = m_arena->Intern(text);
+    if (handle.Id() == m_strings.size()) {
+      m_strings.push_back(handle);
+    }
+    return handle.Id();
+  }
+
+  // Geometric like push_back, so reserving ahead of every append stays amortized O(1).
+  template <typename T> static void Reserve(std::vector<T> &values, size_t extra) {
+    if (values.capacity() - values.size() < extra) {
+      values.reserve(std::max(values.size() + extra, values.capacity() * 2));
+    }
+  }
+
+  const std::vector<uint32_t> &Column(Field field) const {
+    switch (field) {
+    case Field::Name:
+      return m_names;
+    case Field::Type:
+      return m_types;
+    case Field::Trigger:
+      return m_triggers;
+    case Field::Pin:
+      return m_pins;
+    case Field::FreqListName:
+      return m_freq_list_names;
+    case Field::WaveFile:
+      return m_wave_files;
+    case Field::FreqListFile:
+      return m_freq_list_files;
+    }
+    throw std::runtime_error("Invalid stim field.");
+  }
+
+  std::shared_ptr<StringArena> m_arena;
+  std::vector<InternedString> m_strings; // id -> text
+
+  std::vector<uint32_t> m_names;
+  std::vector<uint32_t> m_types;
+  std::vector<uint32_t> m_triggers;
+  std::vector<uint32_t> m_pins;
+  std::vector<uint32_t> m_freq_list_names;
+  std::vector<uint32_t> m_wave_files;
+  std::vector<uint32_t> m_freq_list_files;
+  std::vector<Slice> m_index_slices;
+  std::vector<Slice> m_power_slices;
+  std::vector<Slice> m_field_slices; // ids of the row's fields as appended
+  std::vector<size_t> m_repeat_counts;
+  std::vector<FreqTablePtr> m_freq_tables; // shared with every other stim on the same list
+
+  BlockArray<size_t> m_indexs;
+  BlockArray<double> m_powers;
+  BlockArray<uint32_t> m_fields;
+};
+
+#endif // STIM_TABLE_H
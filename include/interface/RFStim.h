@@ -2,7 +2,9 @@
 #define RF_STIM_H
 
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include ""
@@ -16,7 +18,12 @@ public:
   NRFStim();
   ~NRFStim();
 
-  RF_STIM_DEF &Config(const std::string &stimName) {}
+  RF_STIM_DEF &Config(const std::string &stimName);
+  // Configures a whole test plan: all stims and their frequency lists are resolved with one batch
+  // query per config file instead of one query per stim.
+  void ConfigAll(const std::vector<std::string> &stimNames);
+  // Names of the configured stims on a pin.
+  std::vector<std::string> GetStimsOnPin(const std::string &pin) const;
 
 protected:
   void Restore();
@@ -32,6 +39,11 @@ class RF_STIM_DEF {
 
 public:
   explicit RF_STIM_DEF(const std::vector<std::string> &stimDefs, const std::string &flist);
+  explicit RF_STIM_DEF(const InternedRow &stimDefs, const std::string &flist);
+  // Definition stored as a row of a table shared with other stims.
+  RF_STIM_DEF(const std::shared_ptr<StimTable> &table, const InternedRow &stimDefs, const std::string &flist);
+  RF_STIM_DEF(const std::shared_ptr<StimTable> &table, std::span<const std::string_view> stimDefs,
+              const std::string &flist);
   ~RF_STIM_DEF();
 
   RF_STIM_DEF &Load();
@@ -5,14 +5,27 @@
 #include <memory>
 #include <vector>
 #include <functional>
+#include <map>
 #include <any>
+#include <chrono>
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
 #include <set>
+#include <span>
 #include <thread>
 #include <queue>
+#include <string_view>
+#include <unordered_map>
+#include <mutex>
 
 class BaseIO{
     public:
      virtual size_t Read(char* buffer, size_t filesize) = 0;
+     // Whole-source view for backends that keep the data resident (mmap), empty otherwise.
+     virtual std::string_view View() const { return {}; }
      virtual ~BaseIO() = default;
 };
 
@@ -32,17 +45,132 @@ class CFileIO : public BaseIO{
     // TODO: Add support for C files handler 
 };
 
+class MMapIO : public BaseIO{
+    public:
+    explicit MMapIO(const std::string& filename);
+    MMapIO(const MMapIO& ) = delete;
+    MMapIO& operator=(const MMapIO& ) = delete;
+    ~MMapIO() override;
+
+    size_t Read(char* buffer, size_t filesize) override;
+    std::string_view View() const override { return {m_data, m_size}; }
+
+    private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_read_pos = 0;
+};
+
+enum class IOMode { Stream, MemoryMapped };
+
+struct FileStamp{
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    bool operator==(const FileStamp& ) const = default;
+};
+
+// Wall-clock cost of the phases of the last parse (or snapshot load) of a file. Row split and column
+// split overlap with each other per chunk in the chunked parser and report the slowest chunk; the
+// per-row column count check is part of the column split.
+struct ParseStats{
+    size_t file_size = 0;
+    size_t rows = 0;
+    size_t columns = 0;
+    bool from_snapshot = false;
+    std::chrono::nanoseconds open{0};          // open the file and get its size
+    std::chrono::nanoseconds read{0};          // copy or map the text
+    std::chrono::nanoseconds split_rows{0};
+    std::chrono::nanoseconds split_columns{0};
+    std::chrono::nanoseconds validate{0};      // snapshot revalidation against the source
+    std::chrono::nanoseconds index{0};         // key and secondary index builds
+};
+
+// Adds its own lifetime to a duration.
+class PhaseTimer{
+    public:
+    explicit PhaseTimer(std::chrono::nanoseconds& total) : m_total(total), m_start(std::chrono::steady_clock::now()){}
+    PhaseTimer(const PhaseTimer& ) = delete;
+    PhaseTimer& operator=(const PhaseTimer& ) = delete;
+    ~PhaseTimer(){ m_total += std::chrono::steady_clock::now() - m_start; }
+
+    private:
+    std::chrono::nanoseconds& m_total;
+    std::chrono::steady_clock::time_point m_start;
+};
+
 namespace CSVUtils{
     inline namespace FileOperations{
         bool CheckFileExtension(const std::string& filename, const std::string& ext);
         size_t CalFileByteSize(std::ifstream& in);
         std::unique_ptr<BaseIO> CreateFileHandler(std::ifstream& in);
+        std::unique_ptr<BaseIO> CreateMappedFileHandler(const std::string& filename);
+        FileStamp StampFile(const std::string& filename);
+        std::string SnapshotPath(const std::string& filename);
+        // Temp file next to `filename`, unique per process and call so concurrent writers never share one.
+        std::string UniqueTempName(const std::string& filename);
+        uint64_t HashBytes(std::string_view bytes) noexcept;
     };
 
     inline namespace ParseOperations{
         std::vector<std::string_view> SplitRow(std::string_view row, const char& ch);
+        void SplitRowInto(std::string_view row, const char& ch, std::vector<std::string_view>& out);
+        // SplitRowInto for a single row (no '\n') that stops after the first `limit` fields.
+        void SplitFieldsInto(std::string_view row, const char& ch, size_t limit, std::vector<std::string_view>& out);
         std::vector<std::string_view> SplitSkipHeaderRow(std::string_view row, const char& ch);
         std::string_view SplitHeaderRow(std::string_view header, const char& ch);
+        size_t FindRowBoundary(std::string_view buffer, size_t from);
+        size_t FindLastRowBoundary(std::string_view buffer);
+    };
+
+    inline namespace ConvertOperations{
+        // Parses one numeric token in place; surrounding whitespace and a leading '+' are accepted.
+        template<typename T>
+        void ParseNumber(std::string_view token, T& value){
+            static_assert(std::is_arithmetic_v<T>, "Template parameter T must be a numeric type.");
+            const char* first = token.data();
+            const char* last = token.data() + token.size();
+            while(first != last && std::isspace(static_cast<unsigned char>(*first))) ++first;
+            while(last != first && std::isspace(static_cast<unsigned char>(last[-1]))) --last;
+            if(first != last && *first == '+') ++first;
+            auto [ptr, ec] = std::from_chars(first, last, value);
+            if(ec == std::errc::result_out_of_range)
+                throw std::runtime_error("Conversion value out of range for: " + std::string(token));
+            if(ec != std::errc() || ptr != last)
+                throw std::runtime_error("Conversion value failed for: " + std::string(token));
+        }
+
+        // Non-throwing ParseNumber, for probing fields that may not hold a number at all.
+        template<typename T>
+        bool TryParseNumber(std::string_view token, T& value) noexcept{
+            static_assert(std::is_arithmetic_v<T>, "Template parameter T must be a numeric type.");
+            const char* first = token.data();
+            const char* last = token.data() + token.size();
+            while(first != last && std::isspace(static_cast<unsigned char>(*first))) ++first;
+            while(last != first && std::isspace(static_cast<unsigned char>(last[-1]))) --last;
+            if(first != last && *first == '+') ++first;
+            auto [ptr, ec] = std::from_chars(first, last, value);
+            return ec == std::errc() && ptr == last;
+        }
+
+        // Appends every delim-separated value of text to out, tokenizing like SplitRow.
+        template<typename T>
+        void ParseNumericList(std::string_view text, char delim, std::vector<T>& out){
+            if(text.empty()) return;
+            size_t start = 0;
+            while(true){
+                size_t pos = text.find(delim, start);
+                ParseNumber(text.substr(start, pos - start), out.emplace_back());
+                if(pos == std::string_view::npos) break;
+                start = pos + 1;
+            }
+        }
+
+        template<typename T>
+        std::vector<T> ParseNumericList(std::string_view text, char delim){
+            std::vector<T> values;
+            ParseNumericList(text, delim, values);
+            return values;
+        }
     };
 };
 
@@ -64,7 +192,7 @@ class FileManager{
     explicit FileManager(const std::string& filename);
     ~FileManager() =  default;
 
-    std::unique_ptr<BaseIO> CreateFileHandler();
+    std::unique_ptr<BaseIO> CreateFileHandler(IOMode mode = IOMode::Stream);
     size_t GetFileSize() const noexcept { return m_file_size; }
     std::string GetFileName() const noexcept { return m_file_handle->GetHandleContext(); }
 
@@ -74,36 +202,360 @@ class FileManager{
     std::unique_ptr<FileHandle> m_file_handle = nullptr;
 };
 
+// Raw little helpers for the binary table snapshot; the reader throws on truncated input.
+class ByteWriter{
+    public:
+    template<typename T>
+    void Put(const T& value){
+        static_assert(std::is_trivially_copyable_v<T>);
+        m_bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    template<typename T>
+    void PutArray(const std::vector<T>& values){
+        static_assert(std::is_trivially_copyable_v<T>);
+        Put<uint64_t>(values.size());
+        m_bytes.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+    const std::string& Data() const noexcept { return m_bytes; }
+
+    private:
+    std::string m_bytes;
+};
+
+class ByteReader{
+    public:
+    explicit ByteReader(std::string_view bytes) : m_bytes(bytes){}
+    template<typename T>
+    T Get(){
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+        return value;
+    }
+    template<typename T>
+    void GetArray(std::vector<T>& values){
+        static_assert(std::is_trivially_copyable_v<T>);
+        auto count = Get<uint64_t>();
+        if(count > m_bytes.size() / sizeof(T)) throw std::runtime_error("Truncated snapshot.");
+        values.resize(count);
+        std::memcpy(values.data(), Take(count * sizeof(T)), count * sizeof(T));
+    }
+
+    private:
+    const char* Take(size_t size){
+        if(size > m_bytes.size()) throw std::runtime_error("Truncated snapshot.");
+        const char* data = m_bytes.data();
+        m_bytes.remove_prefix(size);
+        return data;
+    }
+    std::string_view m_bytes;
+};
+
+struct FieldSpan{
+    static constexpr uint32_t npos = UINT32_MAX;
+    uint32_t offset = npos;
+    uint32_t length = 0;
+    bool IsValid() const noexcept { return offset != npos; }
+};
+
+// Column-major table of field spans over one source buffer: one flat FieldSpan array per column
+// instead of one heap vector per row. Fields that do not live in the source (edits made through
+// the compatibility row view) are copied into an owned overflow buffer placed after it.
+class ColumnStore{
+    public:
+    class RowView{
+        public:
+        RowView(const ColumnStore& store, size_t row) : m_store(&store), m_row(row){}
+        size_t size() const noexcept;
+        std::string_view operator[](size_t col) const { return m_store->Field(m_row, col); }
+        std::vector<std::string_view> ToVector() const;
+        void CopyTo(std::vector<std::string_view>& out) const;
+
+        private:
+        const ColumnStore* m_store;
+        size_t m_row;
+    };
+
+    class ColumnView{
+        public:
+        ColumnView(const ColumnStore& store, size_t col) : m_store(&store), m_spans(&store.m_columns.at(col)){}
+        size_t size() const noexcept { return m_spans->size(); }
+        std::string_view operator[](size_t row) const { return m_store->Text((*m_spans)[row]); }
+        const std::vector<FieldSpan>& Spans() const noexcept { return *m_spans; }
+
+        private:
+        const ColumnStore* m_store;
+        const std::vector<FieldSpan>* m_spans;
+    };
+
+    void Reset(std::string_view source, size_t columns = 0);
+    void Reserve(size_t rows);
+    void AppendRow(const std::vector<std::string_view>& fields);
+    void Append(const ColumnStore& other);
+    void Assign(const std::vector<std::vector<std::string_view>>& rows);
+    void Clear();
+    void Save(ByteWriter& out) const;
+    void Load(ByteReader& in, std::string_view source);
+
+    size_t RowCount() const noexcept { return m_row_count; }
+    size_t ColumnCount() const noexcept { return m_columns.size(); }
+    std::string_view Source() const noexcept { return m_source; }
+    std::string_view Text(const FieldSpan& span) const noexcept;
+    std::string_view Field(size_t row, size_t col) const;
+    RowView Row(size_t row) const { return RowView(*this, row); }
+    ColumnView Column(size_t col) const { return ColumnView(*this, col); }
+    std::vector<std::vector<std::string_view>> ToRows() const;
+
+    private:
+    FieldSpan MakeSpan(std::string_view field) const;
+    void Widen(size_t columns);
+
+    std::string_view m_source;
+    std::string m_overflow;
+    std::vector<std::vector<FieldSpan>> m_columns;
+    size_t m_row_count = 0;
+};
+
+// Numeric view of one column: a CSR layout with every row's values contiguous in one array. With a
+// delimiter each field is a list ("1|2|3"), with '\0' each field is a single value.
+template<typename T>
+struct TypedColumn{
+    std::vector<uint32_t> offsets{0};
+    std::vector<T> values;
+
+    size_t size() const noexcept { return offsets.size() - 1; }
+    std::span<const T> operator[](size_t row) const {
+        return std::span<const T>(values).subspan(offsets[row], offsets[row + 1] - offsets[row]);
+    }
+
+    void Build(ColumnStore::ColumnView column, char delim){
+        offsets.assign(1, 0);
+        offsets.reserve(column.size() + 1);
+        values.clear();
+        for(size_t row = 0; row < column.size(); ++row){
+            try{
+                if(delim == '\0') CSVUtils::ParseNumber(column[row], values.emplace_back());
+                else CSVUtils::ParseNumericList(column[row], delim, values);
+            }catch(const std::runtime_error& e){
+                throw std::runtime_error(std::string(e.what()) + " at row " + std::to_string(row));
+            }
+            offsets.push_back(static_cast<uint32_t>(values.size()));
+        }
+    }
+
+    void Save(ByteWriter& out) const {
+        out.PutArray(offsets);
+        out.PutArray(values);
+    }
+    void Load(ByteReader& in){
+        in.GetArray(offsets);
+        in.GetArray(values);
+        if(offsets.empty() || !std::is_sorted(offsets.begin(), offsets.end()) || offsets.back() != values.size())
+            throw std::runtime_error("Corrupted snapshot.");
+    }
+};
+
+// Open-addressing hash index from the text of one column to the first row holding it. Slots pack the
+// upper hash bits with row + 1, so lookups take a string_view, compare hashes first and never allocate.
+class KeyIndex{
+    public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    void Build(const ColumnStore& table, size_t column);
+    size_t Find(std::string_view key) const noexcept;
+    void Clear();
+    void Save(ByteWriter& out) const;
+    void Load(ByteReader& in, const ColumnStore& table);
+
+    bool IsBuilt() const noexcept { return m_table != nullptr; }
+    size_t GetColumn() const noexcept { return m_column; }
+    // Point a built index at another table whose key column holds the same keys in the same rows.
+    void Rebind(const ColumnStore& table) noexcept { if(m_table) m_table = &table; }
+    size_t size() const noexcept { return m_size; }
+
+    static uint64_t Hash(std::string_view key) noexcept;
+
+    private:
+    const ColumnStore* m_table = nullptr;
+    size_t m_column = 0;
+    size_t m_size = 0;
+    std::vector<uint64_t> m_slots;
+};
+
+// Keys whose rows were added, removed or modified between two parses of the same file.
+struct TableDiff{
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    std::vector<std::string> changed;
+    bool Empty() const noexcept { return added.empty() && removed.empty() && changed.empty(); }
+};
+
+// Conjunction of column predicates for CSVParser::Select. Equal compares the field text as is; the
+// range forms compare the field as a number and never match a field that does not parse as one.
+class RowQuery{
+    public:
+    enum class Op { Equal, Less, LessEqual, Greater, GreaterEqual, Between };
+
+    struct Predicate{
+        std::string column;
+        Op op = Op::Equal;
+        std::string text;  // Equal
+        double low = 0;    // Greater, GreaterEqual, Between (inclusive)
+        double high = 0;   // Less, LessEqual, Between (inclusive)
+        bool Matches(std::string_view field) const noexcept;
+    };
+
+    RowQuery& Equal(std::string_view column, std::string_view value);
+    RowQuery& Less(std::string_view column, double value){ return Bound(column, Op::Less, value); }
+    RowQuery& LessEqual(std::string_view column, double value){ return Bound(column, Op::LessEqual, value); }
+    RowQuery& Greater(std::string_view column, double value){ return Bound(column, Op::Greater, value); }
+    RowQuery& GreaterEqual(std::string_view column, double value){ return Bound(column, Op::GreaterEqual, value); }
+    RowQuery& Between(std::string_view column, double low, double high);
+
+    const std::vector<Predicate>& GetPredicates() const noexcept { return m_predicates; }
+    bool Empty() const noexcept { return m_predicates.empty(); }
+
+    private:
+    RowQuery& Bound(std::string_view column, Op op, double value);
+    std::vector<Predicate> m_predicates;
+};
+
+// Secondary index over one column, built on request so Select does not scan the table. Rows are grouped
+// by field text for Equal (ascending row ids per value) and sorted by numeric value for the range forms;
+// fields that are not numbers only take part in the text groups.
+class SecondaryIndex{
+    public:
+    void Build(const ColumnStore& table, size_t column);
+    std::span<const uint32_t> Equal(std::string_view value) const noexcept;
+    // rows of a range predicate in value order, not row order
+    std::span<const uint32_t> Range(const RowQuery::Predicate& predicate) const noexcept;
+    size_t GetColumn() const noexcept { return m_column; }
+
+    private:
+    size_t m_column = 0;
+    // field text -> [begin, end) of its rows in m_grouped; keys view the indexed table
+    std::unordered_map<std::string_view, std::pair<uint32_t, uint32_t>> m_groups;
+    std::vector<uint32_t> m_grouped;
+    std::vector<double> m_values; // ascending
+    std::vector<uint32_t> m_ordered; // row of each m_values entry
+};
+
 using OperateStrategyCallback = std::function<void(std::vector<std::vector<std::string_view>>&)>;
 using QueryStrategyCallback = std::function<std::any(const std::vector<std::vector<std::string_view>>&)>;
+// batch views a reused chunk buffer and is only valid during the call; firstRow is its global row index
+using StreamBatchCallback = std::function<void(const ColumnStore& batch, size_t firstRow)>;
+
+constexpr size_t kDefaultStreamChunkSize = 4 << 20;
+// Most text a stream keeps while looking for the end of a row (or the chunk size, if larger). Input with
+// no row boundary in reach, such as a huge field or a long run of blank lines, fails past it.
+constexpr size_t kMaxStreamCarry = 64 << 20;
 
 class ParserImpl{
     public:
     ParserImpl();
     void SetColumnNames(const std::vector<std::string_view>& colNames); // set the first column
-    void ParseRows(const std::unique_ptr<BaseIO>& io, size_t filesize);
-    void ParseColumns(const std::vector<std::string_view>& rows);
-    void AsyncParseColumns(const std::vector<std::string_view>& rows, size_t workers);
+    // Store only these of the declared columns, in declared order; an empty list stores all again.
+    void SetProjection(const std::vector<std::string_view>& columns);
+    bool HasProjection() const noexcept { return !m_projection.empty(); }
+    // Rows may carry undeclared columns after the declared ones; they are neither scanned nor stored.
+    void SetTrailingColumnsAllowed(bool allowed) { m_trailing_columns = allowed; }
+    bool IsTrailingColumnsAllowed() const noexcept { return m_trailing_columns; }
+    std::vector<std::string_view> GetSourceColumnNames() const noexcept { return m_source_col_names; }
+    void ParseRows(std::unique_ptr<BaseIO> io, size_t filesize);
+    void ParseColumns(std::span<const std::string_view> rows);
+    void AsyncParseColumns(std::span<const std::string_view> rows, size_t workers);
+    void ParseChunks(std::unique_ptr<BaseIO> io, size_t filesize, size_t workers);
+    size_t StreamRows(BaseIO& io, size_t chunksize, const StreamBatchCallback& on_batch);
     void WriteToFile(const std::string& filename);
+    void WriteRows(const std::string& filename) const;
     void ClearAllCache();
+    void BuildKeyIndex(size_t column);
+    size_t FindRow(std::string_view key) const noexcept { return m_key_index.Find(key); }
+    bool HasKeyIndex() const noexcept { return m_key_index.IsBuilt(); }
+    size_t GetColumnIndex(std::string_view name) const;
+    // Binary snapshot of the parsed table (row/column offsets, key index, typed columns) for a source
+    // file; loading revalidates the source by size, mtime and content hash and fails soft.
+    bool SaveSnapshot(const std::string& snapshot, const FileStamp& stamp) const;
+    bool LoadSnapshot(const std::string& snapshot, std::unique_ptr<BaseIO> source, size_t filesize, const FileStamp& stamp);
+    // Diff this freshly parsed table against the one it replaces, keyed on previous's index column (the
+    // first column when none). previous's key index is copied when the key order did not change.
+    // previous is only read, so it may keep serving queries meanwhile.
+    TableDiff Reconcile(const ParserImpl& previous);
+    // Secondary indices are kept current across edits and dropped by the next parse.
+    void BuildSecondaryIndex(size_t column);
+    bool HasSecondaryIndex(size_t column) const noexcept { return m_secondary_indices.count(column) > 0; }
+    std::vector<size_t> SelectRows(const RowQuery& query) const;
+    ParseStats GetStats() const noexcept;
+    void RecordOpen(std::chrono::nanoseconds open, size_t filesize) noexcept;
+
+    // Built on first use under m_typed_mutex, so readers sharing a const table may ask concurrently.
+    template<typename T>
+    const TypedColumn<T>& GetTypedColumn(size_t column, char delim) const{
+        static_assert(std::is_same_v<T, double> || std::is_same_v<T, size_t>, "Typed columns hold double or size_t.");
+        std::lock_guard<std::mutex> lock(m_typed_mutex);
+        auto& cache = TypedColumns<T>();
+        auto it = cache.find({column, delim});
+        if(it == cache.end()){
+            TypedColumn<T> typed;
+            typed.Build(m_table.Column(column), delim);
+            it = cache.emplace(std::make_pair(column, delim), std::move(typed)).first;
+        }
+        return it->second;
+    }
 
     std::vector<std::string_view> GetColumnNames() const noexcept { return m_col_names; }
     std::vector<std::string_view> GetAllRows() const noexcept { return m_rows; }
-    std::vector<std::vector<std::string_view>> GetCSVData() const noexcept { return m_data; }
+    std::vector<std::vector<std::string_view>> GetCSVData() const { return RowData(); }
+    std::span<const std::string_view> GetColumnNamesView() const noexcept { return m_col_names; }
+    std::span<const std::string_view> GetAllRowsView() const noexcept { return m_rows; }
+    const std::vector<std::vector<std::string_view>>& GetCSVDataView() const { return RowData(); }
+    const ColumnStore& GetTable() const noexcept { return m_table; }
     size_t GetRowsSize() const noexcept { return m_rows.size(); }
-    size_t GetCSVDataSize() const noexcept { return m_data.size(); }
+    size_t GetCSVDataSize() const noexcept { return m_table.RowCount(); }
 
     void OnOperationCallback(OperateStrategyCallback on_operation);
     std::any OnQueryCallback(QueryStrategyCallback on_query);
 
     private:
     void Initialize();
-    bool ValidateColumnSize(const std::vector<std::string_view>& columns);
+    void ResetParsedState();
+    void LoadBuffer(std::unique_ptr<BaseIO> io, size_t filesize);
+    size_t SplitFields(std::string_view row, std::vector<std::string_view>& scratch,
+                       std::vector<std::string_view>& fields) const;
+    bool ValidateColumnSize(size_t count) const noexcept;
+    void CheckColumnSize(size_t count, size_t row) const;
+    const std::vector<std::vector<std::string_view>>& RowData() const;
+    void ClearTypedColumns();
+    uint64_t ColumnNamesHash() const noexcept;
+
+    template<typename T>
+    auto& TypedColumns() const{
+        if constexpr(std::is_same_v<T, double>) return m_real_columns;
+        else return m_index_columns;
+    }
 
     std::string m_read_buffer;
+    std::unique_ptr<BaseIO> m_source = nullptr; // owns the mapping m_buffer points into
+    std::string_view m_buffer;
     std::vector<std::string_view> m_rows;
-    std::vector<std::string_view> m_col_names;
-    std::vector<std::vector<std::string_view>> m_data;
+    std::vector<std::string_view> m_col_names; // columns of the table
+    std::vector<std::string_view> m_source_col_names; // columns of the file, as declared
+    std::vector<size_t> m_projection; // source position of every table column, empty when all are kept
+    bool m_trailing_columns = false;
+    ColumnStore m_table;
+    KeyIndex m_key_index;
+    std::map<size_t, SecondaryIndex> m_secondary_indices;
+    // typed column caches; nodes never move, so handed-out references survive later insertions
+    mutable std::mutex m_typed_mutex;
+    mutable std::map<std::pair<size_t, char>, TypedColumn<double>> m_real_columns;
+    mutable std::map<std::pair<size_t, char>, TypedColumn<size_t>> m_index_columns;
+    ParseStats m_stats;
+    bool m_edited = false; // the table no longer mirrors the source, so it must not be snapshotted
+    // row-major compatibility view for the callback API, built from m_table on first use; const readers of
+    // a shared table may race to build it, so that happens under m_data_mutex
+    mutable std::mutex m_data_mutex;
+    mutable std::vector<std::vector<std::string_view>> m_data;
+    mutable bool m_data_stale = true;
 };
 
 class ParserStrategy{
@@ -113,18 +565,44 @@ class ParserStrategy{
 
     /* Synchronous && Asynchronous public operations */
     void SetColumnNames(const std::vector<std::string_view>& colNames);
+    void SetProjection(const std::vector<std::string_view>& columns) { m_parser_impl->SetProjection(columns); }
+    bool HasProjection() const noexcept { return m_parser_impl->HasProjection(); }
+    void SetTrailingColumnsAllowed(bool allowed) { m_parser_impl->SetTrailingColumnsAllowed(allowed); }
+    bool IsTrailingColumnsAllowed() const noexcept { return m_parser_impl->IsTrailingColumnsAllowed(); }
+    std::vector<std::string_view> GetSourceColumnNames() const noexcept { return m_parser_impl->GetSourceColumnNames(); }
     std::vector<std::string_view> GetColumnNames() const noexcept { return m_parser_impl->GetColumnNames(); }
-    std::vector<std::vector<std::string_view>> GetCSVData() const noexcept{ return m_parser_impl->GetCSVData(); }
+    std::vector<std::vector<std::string_view>> GetCSVData() const { return m_parser_impl->GetCSVData(); }
+    std::span<const std::string_view> GetColumnNamesView() const noexcept { return m_parser_impl->GetColumnNamesView(); }
+    const std::vector<std::vector<std::string_view>>& GetCSVDataView() const { return m_parser_impl->GetCSVDataView(); }
+    const ColumnStore& GetTable() const noexcept { return m_parser_impl->GetTable(); }
     void WriteToFile(const std::string& filename);
     size_t GetRowsSize() const noexcept { return m_parser_impl->GetRowsSize(); }
     size_t GetCSVDataSize() const noexcept { return m_parser_impl->GetCSVDataSize(); }
     void ClearAllCache();
+    void BuildKeyIndex(size_t column) { m_parser_impl->BuildKeyIndex(column); }
+    size_t FindRow(std::string_view key) const noexcept { return m_parser_impl->FindRow(key); }
+    bool HasKeyIndex() const noexcept { return m_parser_impl->HasKeyIndex(); }
+    ColumnStore::RowView GetRow(size_t row) const { return GetTable().Row(row); }
+    size_t GetColumnIndex(std::string_view name) const { return m_parser_impl->GetColumnIndex(name); }
+    template<typename T>
+    const TypedColumn<T>& GetTypedColumn(size_t column, char delim) const{ return m_parser_impl->GetTypedColumn<T>(column, delim); }
+    bool SaveSnapshot(const std::string& snapshot, const FileStamp& stamp) const { return m_parser_impl->SaveSnapshot(snapshot, stamp); }
+    bool LoadSnapshot(const std::string& snapshot, std::unique_ptr<BaseIO> source, size_t filesize, const FileStamp& stamp){
+        return m_parser_impl->LoadSnapshot(snapshot, std::move(source), filesize, stamp);
+    }
+    TableDiff Reconcile(const ParserStrategy& previous) { return m_parser_impl->Reconcile(*previous.m_parser_impl); }
+    void BuildSecondaryIndex(size_t column) { m_parser_impl->BuildSecondaryIndex(column); }
+    bool HasSecondaryIndex(size_t column) const noexcept { return m_parser_impl->HasSecondaryIndex(column); }
+    std::vector<size_t> SelectRows(const RowQuery& query) const { return m_parser_impl->SelectRows(query); }
+    ParseStats GetStats() const noexcept { return m_parser_impl->GetStats(); }
+    void RecordOpen(std::chrono::nanoseconds open, size_t filesize) noexcept { m_parser_impl->RecordOpen(open, filesize); }
 
     void OnOperationCallback(OperateStrategyCallback on_operation);
     std::any OnQueryCallback(QueryStrategyCallback on_query);
+    size_t StreamDataFromCSV(BaseIO& io, size_t chunksize, const StreamBatchCallback& on_batch);
 
     /* Synchronous && Asynchronous unique operations */
-    virtual void ParseDataFromCSV(const std::unique_ptr<BaseIO>& io, size_t filesize) = 0;
+    virtual void ParseDataFromCSV(std::unique_ptr<BaseIO> io, size_t filesize) = 0;
 
     protected:
     std::unique_ptr<ParserImpl> m_parser_impl = nullptr;
@@ -132,19 +610,29 @@ class ParserStrategy{
 
 class SynchronousParser : public ParserStrategy{
     public:
-    void ParseDataFromCSV(const std::unique_ptr<BaseIO>& io, size_t filesize) override;
+    void ParseDataFromCSV(std::unique_ptr<BaseIO> io, size_t filesize) override;
 };
 
 class AsynchronousParser : public ParserStrategy{
     public:
     AsynchronousParser(size_t workers = std::thread::hardware_concurrency());
-    void ParseDataFromCSV(const std::unique_ptr<BaseIO>& io, size_t filesize) override;
+    void ParseDataFromCSV(std::unique_ptr<BaseIO> io, size_t filesize) override;
+
+    private:
+    size_t m_thread_workers = 0;
+};
+
+// Splits the buffer into one slice per worker at row boundaries, so row discovery runs in parallel too.
+class ChunkedParser : public ParserStrategy{
+    public:
+    ChunkedParser(size_t workers = std::thread::hardware_concurrency());
+    void ParseDataFromCSV(std::unique_ptr<BaseIO> io, size_t filesize) override;
 
     private:
     size_t m_thread_workers = 0;
 };
 
-enum class ParserMode { Synchronous, Asynchronous };
+enum class ParserMode { Synchronous, Asynchronous, Chunked };
 
 class CSVParser{
     using CSVData = std::vector<std::vector<std::string_view>>;
@@ -171,22 +659,91 @@ class CSVParser{
         m_parser->SetColumnNames(columnNames);
     }
 
+    // Column projection: keep only the named columns (declared by SetColumnNames, stored in declared
+    // order); fields after the last kept one are only counted, never split, and no other field is stored.
+    // Column names and indices refer to the kept columns. Rows must still have exactly the declared columns.
+    template<typename... Args>
+    void SetProjection(Args&&... args){
+        std::initializer_list<std::string_view> columns{std::forward<Args>(args)...};
+        if(columns.size() == 0) throw std::runtime_error("No column names provided.");
+        m_parser->SetProjection(columns);
+    }
+    // For wide exports declaring only their leading columns: rows need all declared columns, anything
+    // after them is not even scanned. Off by default, so a row longer than declared is an error.
+    void SetTrailingColumnsAllowed(bool allowed) { m_parser->SetTrailingColumnsAllowed(allowed); }
+
     void ParseFromCSV(const std::string& filename);
+    // With snapshots enabled ParseFromCSV first tries "<file>.snap" and only parses the text when it is
+    // missing or stale; SaveSnapshot refreshes it from the current table (best effort).
+    void SetSnapshotEnabled(bool enabled) { m_snapshot_enabled = enabled; }
+    bool IsLoadedFromSnapshot() const noexcept { return m_from_snapshot; }
+    // Phase timings of the current table, see ParseStats.
+    ParseStats GetParseStats() const noexcept;
+    bool SaveSnapshot() const;
+    // Hot reload: IsSourceChanged tells whether the last parsed file changed since. Parse the new version
+    // into CloneConfiguration() (an empty parser set up like this one), then Reconcile it against the
+    // table it replaces. Use IOMode::Stream for files rewritten in place, a mapped table would see the
+    // new bytes before the diff.
+    bool IsSourceChanged() const noexcept;
+    std::unique_ptr<CSVParser> CloneConfiguration() const;
+    TableDiff Reconcile(const CSVParser& previous);
+    // Bounded-memory alternative to ParseFromCSV: nothing is retained, rows are handed out per chunk. Text
+    // without a row boundary for more than kMaxStreamCarry bytes (or chunksize, if larger) throws.
+    size_t StreamFromCSV(const std::string& filename, StreamBatchCallback on_batch,
+                         size_t chunksize = kDefaultStreamChunkSize);
+    // Throws for a table parsed with a projection or with trailing columns allowed, which would lose
+    // the columns the parse skipped.
     void WriteToCSV(const std::string& filename);
     void SetParser(ParserMode mode, size_t workers = std::thread::hardware_concurrency());
+    void SetIOMode(IOMode mode) { m_io_mode = mode; }
     void OnAdd(OperateStrategyCallback add);
     void OnDelete(OperateStrategyCallback del);
     void OnUpdate(OperateStrategyCallback update);
     std::any OnQuery(QueryStrategyCallback query);
+    // Index a column (the name column by default) so FindRow is a hash lookup; kept current across edits.
+    void BuildKeyIndex(size_t column = 0);
+    size_t FindRow(std::string_view key) const noexcept;
+    bool HasKeyIndex() const noexcept;
+    ColumnStore::RowView GetRow(size_t row) const;
+    // Rows matching every predicate of query, in row order. Columns are the SetColumnNames names; a
+    // column with a secondary index is looked up instead of scanned, the most selective one first.
+    void BuildSecondaryIndex(std::string_view column);
+    bool HasSecondaryIndex(std::string_view column) const;
+    std::vector<size_t> SelectRows(const RowQuery& query) const;
+    std::vector<ColumnStore::RowView> Select(const RowQuery& query) const;
+
+    // Converted once with std::from_chars and cached until the next parse or edit; safe to call on a
+    // table shared between threads. Pass a delimiter such as '|' for list fields, or leave '\0' for one
+    // value per field.
+    template<typename T>
+    const TypedColumn<T>& GetTypedColumn(std::string_view column, char delim = '\0') const{
+        return m_parser->GetTypedColumn<T>(m_parser->GetColumnIndex(column), delim);
+    }
 
     std::vector<std::string_view> GetColumnNames() const noexcept;
-    std::vector<std::vector<std::string_view>> GetCSVData() const noexcept;
+    std::vector<std::vector<std::string_view>> GetCSVData() const;
+    // Copy-free accessors; the views stay valid until the next parse, edit or Close().
+    std::span<const std::string_view> GetColumnNamesView() const noexcept;
+    const CSVData& GetCSVDataView() const;
+    const ColumnStore& GetTable() const noexcept;
     size_t GetDataSize() const noexcept;
     void Close();
 
     private:
+    static std::unique_ptr<ParserStrategy> CreateStrategy(ParserMode mode, size_t workers);
+
     std::unique_ptr<ParserStrategy> m_parser = nullptr;
-    
+    ParserMode m_parser_mode = ParserMode::Synchronous;
+    size_t m_parser_workers = 0;
+    std::string m_source_file;
+    FileStamp m_source_stamp;
+    bool m_snapshot_enabled = false;
+    bool m_from_snapshot = false;
+#ifdef _WIN32
+    IOMode m_io_mode = IOMode::Stream;
+#else
+    IOMode m_io_mode = IOMode::MemoryMapped;
+#endif
 };
 
 #endif
\ No newline at end of file
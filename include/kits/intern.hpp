@@ -0,0 +1,81 @@
+#ifndef STRING_ARENA_HPP
+#define STRING_ARENA_HPP
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Handle to a string interned in a StringArena: 16 bytes, the text stays valid as long as the arena lives.
+// Equal strings of one arena share their id and stored text, so handles of the same arena compare by
+// pointer; handles of different arenas fall back to comparing text. Invalid handles equal no handle.
+class InternedString {
+public:
+  static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+  InternedString() = default;
+
+  uint32_t Id() const noexcept { return m_id; }
+  bool IsValid() const noexcept { return m_id != npos; }
+  std::string_view View() const noexcept { return {m_data, m_size}; }
+  std::string Str() const { return std::string(View()); }
+  operator std::string_view() const noexcept { return View(); }
+
+  friend bool operator==(const InternedString &lhs, const InternedString &rhs) noexcept {
+    if (!lhs.IsValid() || !rhs.IsValid())
+      return false;
+    return lhs.m_data == rhs.m_data ? lhs.m_size == rhs.m_size : lhs.View() == rhs.View();
+  }
+  friend bool operator==(const InternedString &lhs, std::string_view rhs) noexcept { return lhs.View() == rhs; }
+
+private:
+  friend class StringArena;
+  InternedString(const char *data, uint32_t size, uint32_t id) : m_data(data), m_size(size), m_id(id) {}
+
+  const char *m_data = "";
+  uint32_t m_size = 0;
+  uint32_t m_id = npos;
+};
+
+// Append-only intern table. Text is copied once into large blocks and never moves, so handed-out
+// handles and views stay valid until the arena is destroyed. Safe to use from many threads.
+class StringArena {
+public:
+  StringArena() = default;
+  StringArena(const StringArena &) = delete;
+  StringArena &operator=(const StringArena &) = delete;
+
+  InternedString Intern(std::string_view text);
+  // Lookup without inserting; an invalid handle when text was never interned.
+  InternedString Find(std::string_view text) const;
+
+  size_t size() const;
+  size_t GetByteSize() const;
+
+private:
+  const char *Store(std::string_view text);
+
+  static constexpr size_t kBlockSize = 16 << 10;
+
+  mutable std::shared_mutex m_mutex;
+  std::vector<std::unique_ptr<char[]>> m_blocks;
+  char *m_block = nullptr; // block small strings are appended to
+  size_t m_block_used = 0;
+  size_t m_bytes = 0;
+  std::unordered_map<std::string_view, InternedString> m_index; // keys view the stored text
+};
+
+// Interned fields of one row plus whatever keeps their arena alive.
+struct InternedRow {
+  std::vector<InternedString> fields;
+  std::shared_ptr<const void> owner;
+
+  bool empty() const noexcept { return fields.empty(); }
+  size_t size() const noexcept { return fields.size(); }
+  const InternedString &at(size_t i) const { return fields.at(i); }
+};
+
+#endif // STRING_ARENA_HPP
@@ -0,0 +1,46 @@
+#ifndef RCU_PTR_HPP
+#define RCU_PTR_HPP
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+// Read-copy-update cell for an immutable value. Readers take a reference-counted copy of the current
+// value and keep using it for as long as they hold it; a writer builds the next value on the side and
+// swaps it in. The internal lock only covers copying the pointer itself, so readers never wait for a
+// writer to build anything, and the replaced value is released outside of it.
+template <typename T> class RcuPtr {
+public:
+  RcuPtr() = default;
+  explicit RcuPtr(std::shared_ptr<const T> value) : m_value(std::move(value)) {}
+  RcuPtr(const RcuPtr &) = delete;
+  RcuPtr &operator=(const RcuPtr &) = delete;
+
+  std::shared_ptr<const T> Load() const {
+    Lock();
+    auto value = m_value;
+    Unlock();
+    return value;
+  }
+
+  void Store(std::shared_ptr<const T> value) {
+    Lock();
+    m_value.swap(value);
+    Unlock();
+  }
+
+private:
+  void Lock() const {
+    while (m_lock.exchange(true, std::memory_order_acquire)) {
+      while (m_lock.load(std::memory_order_relaxed)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+  void Unlock() const { m_lock.store(false, std::memory_order_release); }
+
+  mutable std::atomic<bool> m_lock{false};
+  std::shared_ptr<const T> m_value;
+};
+
+#endif // RCU_PTR_HPP
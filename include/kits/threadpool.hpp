@@ -0,0 +1,63 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Long-lived work-stealing pool. Every worker owns a deque: it pops its own work from the back and
+// steals from the front of the others when idle. The caller of a ParallelFor runs chunks of that same
+// loop until none are left, never unrelated tasks, so nested use from inside a task cannot deadlock the
+// pool and a caller holding a lock never picks up work that needs it.
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+  using RangeTask = std::function<void(size_t begin, size_t end)>;
+
+  explicit ThreadPool(size_t workers = std::thread::hardware_concurrency());
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ~ThreadPool();
+
+  static ThreadPool &Shared();
+
+  size_t GetWorkerCount() const noexcept { return m_threads.size(); }
+
+  // Calls fn(begin, end) for consecutive chunks of at most `grain` items covering [0, count). Blocks
+  // until all chunks ran and rethrows the first exception; chunks not started after a failure are skipped.
+  void ParallelFor(size_t count, size_t grain, const RangeTask &fn);
+
+  template <typename F> auto Submit(F &&fn) -> std::future<std::invoke_result_t<F>> {
+    auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(fn));
+    auto future = task->get_future();
+    Push([task] { (*task)(); });
+    return future;
+  }
+
+private:
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void Push(Task task);
+  bool TryRunOne();
+  void WorkerLoop(size_t index);
+
+  std::vector<std::unique_ptr<WorkQueue>> m_queues;
+  std::vector<std::thread> m_threads;
+  std::mutex m_wake_mutex;
+  std::condition_variable m_wake;
+  std::atomic<size_t> m_pending{0};
+  std::atomic<size_t> m_next_queue{0};
+  bool m_stop = false;
+};
+
+#endif // THREAD_POOL_HPP
@@ -10,11 +10,11 @@
 #include "impl/RFConfigManager.h"
 
 namespace RFUTILS {
-std::vector<std::string> DoSplit(const std::string &str, char ch) {
+inline std::vector<std::string> DoSplit(const std::string &str, char ch) {
   std::vector<std::string_view> SplitView = CSVUtils::ParseOperations::SplitRow(str, ch);
   return std::vector<std::string>{SplitView.begin(), SplitView.end()};
 }
-std::string DoJoin(const std::vector<std::string> &strs, const std::string &delim) {
+inline std::string DoJoin(const std::vector<std::string> &strs, const std::string &delim) {
   std::stringstream ss;
   for (size_t i = 0; i < strs.size() - 1; ++i) {
     ss << strs[i] << delim;
@@ -23,12 +23,34 @@ std::string DoJoin(const std::vector<std::string> &strs, const std::string &deli
   return ss.str();
 }
 
-std::vector<std::string> DoQuery(const std::string &config, const std::string &queryCommand) {
-  std::vector<std::string_view> queryResult;
-  QuerySequence sequence{.queryCommand = queryCommand, .queryResult = queryResult};
+inline std::vector<std::string> DoQuery(const std::string &config, const std::string &queryCommand) {
+  QuerySequence sequence{queryCommand};
   RFConfigManager::GetInstance().OnQuery(config, sequence);
   return std::vector<std::string>{sequence.queryResult.begin(), sequence.queryResult.end()};
 }
+
+// Like DoQuery, but the fields come back as handles interned in the config snapshot's arena instead of
+// fresh strings; the row keeps the snapshot alive. Empty when the key is not found.
+inline InternedRow DoInternedQuery(const std::string &config, const std::string &queryCommand) {
+  QuerySequence sequence{queryCommand};
+  sequence.internResult = true;
+  RFConfigManager::GetInstance().OnQuery(config, sequence);
+  return InternedRow{std::move(sequence.queryInterned), std::move(sequence.queryOwner)};
+}
+
+// All keys of one config in a single call; rows are views, see BatchQueryResult.
+inline BatchQueryResult DoBatchQuery(const std::string &config, std::span<const std::string> queryCommands) {
+  BatchQueryResult result;
+  RFConfigManager::GetInstance().OnBatchQuery(config, queryCommands, result);
+  return result;
+}
+
+// All rows of a config matching query, e.g. RowQuery().Equal("PinName", pin).Equal("TriggerType", trigger).
+inline BatchQueryResult DoSelect(const std::string &config, const RowQuery &query) {
+  BatchQueryResult result;
+  RFConfigManager::GetInstance().OnSelect(config, query, result);
+  return result;
+}
 }; // namespace RFUTILS
 
 #endif // RF_UTILS_HPP
\ No newline at end of file
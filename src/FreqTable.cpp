@@ -0,0 +1,49 @@
+#include "impl/FreqTable.h"
+
+#if !defined(_WIN32) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FREQ_SIMD_GATHER
+#include <immintrin.h>
+#endif
+
+namespace {
+using GatherFn = void (*)(const double *, const size_t *, double *, size_t);
+
+void GatherScalar(const double *values, const size_t *indexs, double *out, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = values[indexs[i]];
+  }
+}
+
+#ifdef FREQ_SIMD_GATHER
+// indexes are validated against the table before, so the signed 64-bit lanes never see a huge value
+__attribute__((target("avx2"))) void GatherAVX2(const double *values, const size_t *indexs, double *out,
+                                                size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(indexs + i));
+    _mm256_storeu_pd(out + i, _mm256_i64gather_pd(values, lanes, sizeof(double)));
+  }
+  GatherScalar(values, indexs + i, out + i, count - i);
+}
+#endif
+
+GatherFn SelectGather() {
+#ifdef FREQ_SIMD_GATHER
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return GatherAVX2;
+#endif
+  return GatherScalar;
+}
+} // namespace
+
+void FreqTable::Gather(std::span<const size_t> indexs, std::span<double> out) const {
+  if (sweep) {
+    for (size_t i = 0; i < indexs.size(); ++i) {
+      out[i] = sweep->At(indexs[i]);
+    }
+    return;
+  }
+  static const GatherFn gather = SelectGather();
+  gather(values.data(), indexs.data(), out.data(), indexs.size());
+}
@@ -1,47 +1,260 @@
 #include "impl/RFConfigManager.h"
 #include "kits/csvparser.hpp"
+#include "kits/threadpool.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+std::string GetExtension(const std::string &config) {
+  size_t pos = config.find_last_of(".");
+  return pos == std::string::npos ? std::string() : config.substr(pos);
+}
+
+std::string JsonString(const std::string &text) {
+  std::ostringstream out;
+  out << '"';
+  for (unsigned char ch : text) {
+    if (ch == '"' || ch == '\\') {
+      out << '\\' << ch;
+    } else if (ch < 0x20) {
+      out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int{ch} << std::dec;
+    } else {
+      out << ch;
+    }
+  }
+  out << '"';
+  return out.str();
+}
+
+double Millis(std::chrono::nanoseconds duration) { return std::chrono::duration<double, std::milli>(duration).count(); }
+double Micros(std::chrono::nanoseconds duration) { return std::chrono::duration<double, std::micro>(duration).count(); }
+} // namespace
 
 ConfiguratorListener::ConfiguratorListener(const std::string &filename)
-    : m_config(filename), m_parser_proxy(std::make_shared<CSVParser>(ParserMode::Synchronous)) {}
+    : m_config(filename), m_parser_proxy(std::make_shared<CSVParser>(ParserMode::Chunked)) {
+  m_parser_proxy->SetSnapshotEnabled(true);
+  // Any config can be hot-reloaded and editors rewrite files in place, so tables own a copy of the text:
+  // a mapping would show readers (and Reconcile) the new bytes early, or fault once the file shrinks.
+  m_parser_proxy->SetIOMode(IOMode::Stream);
+}
 
 ConfiguratorListener::~ConfiguratorListener() { this->Cleanup(); }
 
+template <typename F> void ConfiguratorListener::RunAsLoader(F &&load) {
+  m_loading_thread = std::this_thread::get_id();
+  try {
+    load();
+  } catch (...) {
+    m_loading_thread = std::thread::id{};
+    throw;
+  }
+  m_loading_thread = std::thread::id{};
+}
+
 void ConfiguratorListener::HandleEvent(EventType type, QuerySequence &query) {
   if (type == EventType::CONFIG_LOAD) {
-    OnLoadEvent(m_config);
+    // same path as lazy loads and prefetches: a config that is loaded already is not parsed again, one
+    // being loaded by another thread (a prefetch, say) is waited for
+    EnsureLoaded();
+  } else if (type == EventType::CONFIG_RELOAD) {
+    // a change callback of this very load or reload asking for a reload would wait on itself
+    if (m_loading_thread.load() == std::this_thread::get_id()) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(m_load_mutex);
+    RunAsLoader([this] { OnReloadEvent(); });
   } else {
+    if (!IsConfigLoaded() && m_lazy_load) {
+      EnsureLoaded();
+    }
     if (!IsConfigLoaded()) {
       throw std::runtime_error("ConfiguratorListener::HandleEvent: Configuration file not loaded yet");
     }
     if (type == EventType::CONFIG_QUERY) {
+      auto start = std::chrono::steady_clock::now();
       OnQueryEvent(query);
+      RecordQuery(start);
     }
   }
 }
 
+void ConfiguratorListener::HandleBatchQuery(std::span<const std::string> keys, BatchQueryResult &result) {
+  if (!IsConfigLoaded() && m_lazy_load) {
+    EnsureLoaded();
+  }
+  auto table = m_table.Load();
+  if (!table) {
+    throw std::runtime_error("ConfiguratorListener::HandleBatchQuery: Configuration file not loaded yet");
+  }
+  auto start = std::chrono::steady_clock::now();
+  const auto &parser = *table->parser;
+  const size_t width = parser.GetTable().ColumnCount();
+  result.width = width;
+  result.rows.assign(keys.size(), BatchQueryResult::npos);
+  result.fields.assign(keys.size() * width, std::string_view());
+  result.interned.assign(result.intern ? keys.size() * width : 0, InternedString());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    size_t row = parser.FindRow(keys[i]);
+    if (row == KeyIndex::npos) {
+      continue;
+    }
+    result.rows[i] = row;
+    auto fields = parser.GetRow(row);
+    for (size_t col = 0; col < fields.size(); ++col) {
+      result.fields[i * width + col] = fields[col];
+      if (result.intern) {
+        result.interned[i * width + col] = table->arena.Intern(fields[col]);
+      }
+    }
+  }
+  result.owner = std::move(table);
+  RecordQuery(start);
+}
+
+void ConfiguratorListener::HandleSelect(const RowQuery &query, BatchQueryResult &result) {
+  if (!IsConfigLoaded() && m_lazy_load) {
+    EnsureLoaded();
+  }
+  auto table = m_table.Load();
+  if (!table) {
+    throw std::runtime_error("ConfiguratorListener::HandleSelect: Configuration file not loaded yet");
+  }
+  auto start = std::chrono::steady_clock::now();
+  const auto &parser = *table->parser;
+  const size_t width = parser.GetTable().ColumnCount();
+  result.width = width;
+  result.rows = parser.SelectRows(query);
+  result.fields.assign(result.rows.size() * width, std::string_view());
+  result.interned.assign(result.intern ? result.rows.size() * width : 0, InternedString());
+  for (size_t i = 0; i < result.rows.size(); ++i) {
+    auto fields = parser.GetRow(result.rows[i]);
+    for (size_t col = 0; col < fields.size(); ++col) {
+      result.fields[i * width + col] = fields[col];
+      if (result.intern) {
+        result.interned[i * width + col] = table->arena.Intern(fields[col]);
+      }
+    }
+  }
+  result.owner = std::move(table);
+  RecordQuery(start);
+}
+
+void ConfiguratorListener::EnsureLoaded(bool wait) {
+  // The second check only catches re-entry from the load's own stack: a waiting ParallelFor runs chunks
+  // of its own loop and never another task, so no other load or query can land on this thread meanwhile.
+  if (IsConfigLoaded() || m_loading_thread.load() == std::this_thread::get_id()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(m_load_mutex, std::defer_lock);
+  if (wait) {
+    lock.lock();
+  } else if (!lock.try_lock()) {
+    return;
+  }
+  // a prefetch or another query may have finished the load while we waited
+  if (!IsConfigLoaded()) {
+    RunAsLoader([this] { OnLoadEvent(m_config); });
+  }
+}
+
 void ConfiguratorListener::OnLoadEvent(const std::string &filename) {
-  m_parser_proxy->ParseFromCSV(filename);
+  auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<CSVParser> parser = m_parser_proxy->CloneConfiguration();
+  parser->ParseFromCSV(filename);
+  if (!parser->IsLoadedFromSnapshot() || !parser->HasKeyIndex()) {
+    parser->BuildKeyIndex(0);
+    parser->SaveSnapshot();
+  }
+  for (const auto &column : m_indexed_columns) {
+    parser->BuildSecondaryIndex(column);
+  }
+  m_table.Store(std::make_shared<const ConfigTable>(std::move(parser)));
+  m_load_nanos = (std::chrono::steady_clock::now() - start).count();
+  ++m_load_count;
   SetConfigLoadStatus(true);
+  if (m_on_table_changed) {
+    m_on_table_changed(m_config);
+  }
+}
+
+void ConfiguratorListener::OnReloadEvent() {
+  m_last_reload.reset();
+  auto current = m_table.Load();
+  // a config that was never loaded picks up the current file on its first load
+  if (!IsConfigLoaded() || !current || !current->parser->IsSourceChanged()) {
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  // queries keep reading `current` until the new table is swapped in
+  std::shared_ptr<CSVParser> next = m_parser_proxy->CloneConfiguration();
+  next->ParseFromCSV(m_config);
+  auto diff = next->Reconcile(*current->parser);
+  if (!next->HasKeyIndex()) {
+    next->BuildKeyIndex(0);
+  }
+  next->SaveSnapshot();
+  m_table.Store(std::make_shared<const ConfigTable>(std::move(next)));
+  m_load_nanos = (std::chrono::steady_clock::now() - start).count();
+  ++m_reload_count;
+  m_last_reload = ConfigReload{m_config, std::move(diff.added), std::move(diff.removed), std::move(diff.changed)};
+  if (m_on_table_changed) {
+    m_on_table_changed(m_config);
+  }
 }
 
 void ConfiguratorListener::OnQueryEvent(QuerySequence &query) {
-  auto queryStrategy = [&query](const std::vector<std::vector<std::string_view>> &data) {
-    for (const auto &row : data) {
-      if (std::string{row[0]} == query.queryCommand) {
-        return row;
-      }
+  auto table = m_table.Load();
+  if (!table) {
+    throw std::runtime_error("ConfiguratorListener::HandleEvent: Configuration file not loaded yet");
+  }
+  auto row = table->parser->FindRow(query.queryCommand);
+  if (row == KeyIndex::npos) {
+    query.queryResult.clear();
+  } else {
+    table->parser->GetRow(row).CopyTo(query.queryResult);
+  }
+  if (query.internResult) {
+    query.queryInterned.clear();
+    for (auto field : query.queryResult) {
+      query.queryInterned.push_back(table->arena.Intern(field));
     }
-    return std::vector<std::string_view>{};
-  };
-  auto result = m_parser_proxy->OnQuery(queryStrategy);
-  if (!result.has_value()) {
-    throw std::runtime_error("ConfiguratorListener::OnQueryEvent: No result found for query");
   }
-  try {
-    query.queryResult = std::any_cast<std::vector<std::string_view>>(result);
-  } catch (const std::bad_any_cast &e) {
-    throw std::runtime_error("ConfiguratorListener::OnQueryEvent: Invalid query result type");
+  query.queryOwner = std::move(table);
+}
+
+void ConfiguratorListener::RecordQuery(std::chrono::steady_clock::time_point start) {
+  int64_t nanos = (std::chrono::steady_clock::now() - start).count();
+  ++m_query_count;
+  m_query_nanos += nanos;
+  int64_t max = m_query_max_nanos.load();
+  while (nanos > max && !m_query_max_nanos.compare_exchange_weak(max, nanos)) {
+  }
+}
+
+ConfigStats ConfiguratorListener::GetStats() const {
+  ConfigStats stats;
+  stats.config = m_config;
+  if (auto table = m_table.Load()) {
+    stats.loaded = true;
+    stats.parse = table->parser->GetParseStats();
   }
+  stats.load = std::chrono::nanoseconds(m_load_nanos.load());
+  stats.loads = m_load_count;
+  stats.reloads = m_reload_count;
+  stats.queries = m_query_count;
+  stats.queryTotal = std::chrono::nanoseconds(m_query_nanos.load());
+  stats.queryMax = std::chrono::nanoseconds(m_query_max_nanos.load());
+  return stats;
 }
 
 void ConfiguratorListener::SetConfigLoadStatus(bool status) { isConfigLoaded = status; }
@@ -49,39 +262,55 @@ void ConfiguratorListener::SetConfigLoadStatus(bool status) { isConfigLoaded = s
 void ConfiguratorListener::Cleanup() {
   m_config = "";
   SetConfigLoadStatus(false);
+  m_table.Store(nullptr);
   m_parser_proxy->Close();
 }
 
 StimConfigurator::StimConfigurator(const std::string &stim) : ConfiguratorListener(stim) {
   m_parser_proxy->SetColumnNames("StimName", "StimType", "TriggerType", "PinName", "FreqListName", "FreqListIndex",
                                  "Power", "WaveFile");
+  m_indexed_columns = {"TriggerType", "PinName", "FreqListName"};
 }
 
 MeasConfigurator::MeasConfigurator(const std::string &meas) : ConfiguratorListener(meas) {
   m_parser_proxy->SetColumnNames("MeasName", "TriggerType", "PinName", "FreqListName", "FreqListIndex", "Power");
+  m_indexed_columns = {"TriggerType", "PinName", "FreqListName"};
 }
 
 FlistConfigurator::FlistConfigurator(const std::string &flist) : ConfiguratorListener(flist) {
   m_parser_proxy->SetColumnNames("FreqListName", "FreqListValue");
 }
 
+template <typename F> void EventPublisher::Update(F &&modify) {
+  std::lock_guard<std::mutex> lock(mWriteMutex);
+  auto next = std::make_shared<EventListenerMap>(*mActiveListeners.Load());
+  modify(*next);
+  mActiveListeners.Store(std::move(next));
+}
+
 void EventPublisher::AddListener(const std::string &config, const EventListenerPtr &listener) {
-  mActiveListeners.try_emplace(config, listener);
+  Update([&](EventListenerMap &listeners) { listeners.try_emplace(config, listener); });
 }
 
-void EventPublisher::RemoveOne(const std::string &config) { mActiveListeners.erase(config); }
+void EventPublisher::RemoveOne(const std::string &config) {
+  Update([&](EventListenerMap &listeners) { listeners.erase(config); });
+}
 
-void EventPublisher::RemoveAll() { mActiveListeners.clear(); }
+void EventPublisher::RemoveAll() {
+  Update([](EventListenerMap &listeners) { listeners.clear(); });
+}
 
 void EventPublisher::NotifyAll(EventType type, QuerySequence &maybeUsed) {
-  for (const auto &[config, listener] : mActiveListeners) {
+  auto listeners = mActiveListeners.Load();
+  for (const auto &[config, listener] : *listeners) {
     listener->HandleEvent(type, maybeUsed);
   }
 }
 
 void EventPublisher::NotifyOne(const std::string &config, EventType type, QuerySequence &maybeUsed) {
-  auto listener = mActiveListeners.find(config);
-  if (listener == mActiveListeners.end()) {
+  auto listeners = mActiveListeners.Load();
+  auto listener = listeners->find(config);
+  if (listener == listeners->end()) {
     throw std::runtime_error("EventPublisher::NotifyOne: Listener not found");
   }
   listener->second->HandleEvent(type, maybeUsed);
@@ -99,10 +328,17 @@ void RFConfigManager::SetupConfiguratorFactory() {
   mConfiguratorFactory[".stim"] = [](const std::string &stim) { return std::make_unique<StimConfigurator>(stim); };
   mConfiguratorFactory[".meas"] = [](const std::string &meas) { return std::make_unique<MeasConfigurator>(meas); };
   mConfiguratorFactory[".flist"] = [](const std::string &flist) { return std::make_unique<FlistConfigurator>(flist); };
+  mConfiguratorDependencies[".stim"] = {".flist"};
+  mConfiguratorDependencies[".meas"] = {".flist"};
 }
 void RFConfigManager::DestoryConfiguratorFactory() {
+  DisableHotReload();
+  for (const auto &[config, listener] : *mPublisher.GeActivetListeners()) {
+    NotifyConfigChange(config);
+  }
   mPublisher.RemoveAll();
   mConfiguratorFactory.clear();
+  mConfiguratorDependencies.clear();
 }
 
 void RFConfigManager::CreateConfigurator(const std::string &config) {
@@ -110,7 +346,14 @@ void RFConfigManager::CreateConfigurator(const std::string &config) {
   if (!configurator) {
     throw std::runtime_error("RFConfigManager::CreateConfigurator: Failed to create configurator");
   }
+  if (auto listener = std::dynamic_pointer_cast<ConfiguratorListener>(configurator)) {
+    listener->SetLazyLoad(mLoadPolicy == LoadPolicy::Lazy);
+    listener->SetTableChangedCallback([this](const std::string &changed) { NotifyConfigChange(changed); });
+  }
   mPublisher.AddListener(config, configurator);
+  if (mWatchFd >= 0) {
+    WatchConfig(config);
+  }
 }
 
 void RFConfigManager::CreateConfigurators(const std::vector<std::string> &configs) {
@@ -120,22 +363,161 @@ void RFConfigManager::CreateConfigurators(const std::vector<std::string> &config
 }
 
 void RFConfigManager::OnLoad(const std::string &config) {
-  QuerySequence sequence{"Unused, Just a placeholder", std::vector<std::string_view>{}};
+  QuerySequence sequence{"Unused, Just a placeholder"};
   mPublisher.NotifyOne(config, EventType::CONFIG_LOAD, sequence);
 }
 
 void RFConfigManager::OnLoad() {
-  QuerySequence sequence{"Unused, Just a placeholder", std::vector<std::string_view>{}};
-  mPublisher.NotifyAll(EventType::CONFIG_LOAD, sequence);
+  auto listeners = mPublisher.GeActivetListeners();
+  std::set<std::string> failed; // extensions with at least one config that did not load
+  std::string errors;
+  for (const auto &level : GetLoadLevels()) {
+    std::vector<std::string> levelErrors(level.size());
+    std::vector<bool> skipped(level.size(), false);
+    for (size_t i = 0; i < level.size(); ++i) {
+      for (const auto &dependency : mConfiguratorDependencies[GetExtension(level[i])]) {
+        skipped[i] = skipped[i] || failed.count(dependency) > 0;
+      }
+    }
+    // one task per file; each parser spreads its own file over the same pool
+    ThreadPool::Shared().ParallelFor(level.size(), 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        if (skipped[i]) {
+          levelErrors[i] = level[i] + ": skipped, a config it depends on failed to load";
+          continue;
+        }
+        try {
+          QuerySequence sequence{"Unused, Just a placeholder"};
+          listeners->at(level[i])->HandleEvent(EventType::CONFIG_LOAD, sequence);
+        } catch (const std::exception &e) {
+          levelErrors[i] = level[i] + ": " + e.what();
+        }
+      }
+    });
+    for (size_t i = 0; i < level.size(); ++i) {
+      if (!levelErrors[i].empty()) {
+        failed.insert(GetExtension(level[i]));
+        errors += (errors.empty() ? "" : "; ") + levelErrors[i];
+      }
+    }
+  }
+  if (!errors.empty()) {
+    throw std::runtime_error("RFConfigManager::OnLoad: " + errors);
+  }
+}
+
+std::vector<std::vector<std::string>> RFConfigManager::GetLoadLevels() {
+  // level of an extension = 1 + deepest level among the dependencies that are actually registered
+  std::set<std::string> present;
+  for (const auto &[config, listener] : *mPublisher.GeActivetListeners()) {
+    present.insert(GetExtension(config));
+  }
+  std::unordered_map<std::string, size_t> depth;
+  std::function<size_t(const std::string &, size_t)> Depth = [&](const std::string &ext, size_t guard) -> size_t {
+    if (guard > present.size()) {
+      throw std::runtime_error("RFConfigManager::OnLoad: Circular config dependency at " + ext);
+    }
+    if (auto it = depth.find(ext); it != depth.end()) {
+      return it->second;
+    }
+    size_t level = 0;
+    for (const auto &dependency : mConfiguratorDependencies[ext]) {
+      if (present.count(dependency) > 0) {
+        level = std::max(level, Depth(dependency, guard + 1) + 1);
+      }
+    }
+    return depth[ext] = level;
+  };
+
+  std::vector<std::vector<std::string>> levels;
+  for (const auto &[config, listener] : *mPublisher.GeActivetListeners()) {
+    size_t level = Depth(GetExtension(config), 0);
+    if (levels.size() <= level) {
+      levels.resize(level + 1);
+    }
+    levels[level].push_back(config);
+  }
+  return levels;
 }
 
 void RFConfigManager::OnQuery(const std::string &config, QuerySequence &maybeUsed) {
   mPublisher.NotifyOne(config, EventType::CONFIG_QUERY, maybeUsed);
 }
 
+void RFConfigManager::OnBatchQuery(const std::string &config, std::span<const std::string> keys,
+                                   BatchQueryResult &result) {
+  auto listeners = mPublisher.GeActivetListeners();
+  auto listener = listeners->find(config);
+  if (listener == listeners->end()) {
+    throw std::runtime_error("RFConfigManager::OnBatchQuery: Listener not found");
+  }
+  listener->second->HandleBatchQuery(keys, result);
+}
+
+void RFConfigManager::OnSelect(const std::string &config, const RowQuery &query, BatchQueryResult &result) {
+  auto listeners = mPublisher.GeActivetListeners();
+  auto listener = listeners->find(config);
+  if (listener == listeners->end()) {
+    throw std::runtime_error("RFConfigManager::OnSelect: Listener not found");
+  }
+  listener->second->HandleSelect(query, result);
+}
+
+void RFConfigManager::SetLoadPolicy(LoadPolicy policy) {
+  mLoadPolicy = policy;
+  for (const auto &[config, listener] : *mPublisher.GeActivetListeners()) {
+    if (auto configurator = std::dynamic_pointer_cast<ConfiguratorListener>(listener)) {
+      configurator->SetLazyLoad(policy == LoadPolicy::Lazy);
+    }
+  }
+}
+
+std::future<void> RFConfigManager::Prefetch(const std::string &config) {
+  auto listeners = mPublisher.GeActivetListeners();
+  auto it = listeners->find(config);
+  if (it == listeners->end()) {
+    throw std::runtime_error("RFConfigManager::Prefetch: Listener not found");
+  }
+  auto configurator = std::dynamic_pointer_cast<ConfiguratorListener>(it->second);
+  if (!configurator) {
+    throw std::runtime_error("RFConfigManager::Prefetch: Listener cannot be prefetched");
+  }
+  // the task owns the listener, so removing it meanwhile is safe
+  // never block a pool worker on a load that is already running elsewhere
+  return ThreadPool::Shared().Submit([configurator] { configurator->EnsureLoaded(false); });
+}
+
+void RFConfigManager::Prefetch(const std::vector<std::string> &configs) {
+  for (const auto &config : configs) {
+    Prefetch(config);
+  }
+}
+
+size_t RFConfigManager::SubscribeConfigChange(ConfigChangeCallback callback) {
+  std::lock_guard<std::mutex> lock(mObserverMutex);
+  mObservers.emplace_back(++mNextObserver, std::move(callback));
+  return mNextObserver;
+}
+
+void RFConfigManager::UnsubscribeConfigChange(size_t id) {
+  std::lock_guard<std::mutex> lock(mObserverMutex);
+  std::erase_if(mObservers, [id](const auto &observer) { return observer.first == id; });
+}
+
+void RFConfigManager::NotifyConfigChange(const std::string &config) {
+  std::vector<std::pair<size_t, ConfigChangeCallback>> observers;
+  {
+    std::lock_guard<std::mutex> lock(mObserverMutex);
+    observers = mObservers;
+  }
+  for (const auto &[id, callback] : observers) {
+    callback(config);
+  }
+}
+
 std::string RFConfigManager::GetConfigFileByExtension(const std::string &ext) {
   auto listener = mPublisher.GeActivetListeners();
-  for (const auto &[config, listener] : listener) {
+  for (const auto &[config, listener] : *listener) {
     size_t pos = config.find_last_of(".");
     if (pos == std::string::npos) {
       throw std::runtime_error("RFConfigManager::GetConfigFileByExtension: Invalid file extension");
@@ -147,6 +529,61 @@ std::string RFConfigManager::GetConfigFileByExtension(const std::string &ext) {
   throw std::runtime_error("RFConfigManager::GetConfigFileByExtension: No config file found");
 }
 
+std::vector<ConfigStats> RFConfigManager::GetStats() {
+  std::vector<ConfigStats> stats;
+  for (const auto &[config, listener] : *mPublisher.GeActivetListeners()) {
+    if (auto configurator = std::dynamic_pointer_cast<ConfiguratorListener>(listener)) {
+      stats.push_back(configurator->GetStats());
+    }
+  }
+  std::sort(stats.begin(), stats.end(), [](const ConfigStats &a, const ConfigStats &b) { return a.config < b.config; });
+  return stats;
+}
+
+std::string RFConfigManager::DumpStats(StatsFormat format) {
+  std::ostringstream out;
+  auto stats = GetStats();
+  if (format == StatsFormat::Json) {
+    out << "{\"configs\":[";
+    for (size_t i = 0; i < stats.size(); ++i) {
+      const auto &s = stats[i];
+      const auto &p = s.parse;
+      out << (i == 0 ? "" : ",") << "{\"config\":" << JsonString(s.config)
+          << ",\"loaded\":" << (s.loaded ? "true" : "false") << ",\"fileSize\":" << p.file_size
+          << ",\"rows\":" << p.rows << ",\"columns\":" << p.columns
+          << ",\"fromSnapshot\":" << (p.from_snapshot ? "true" : "false") << ",\"phasesNs\":{\"open\":"
+          << p.open.count() << ",\"read\":" << p.read.count() << ",\"splitRows\":" << p.split_rows.count()
+          << ",\"splitColumns\":" << p.split_columns.count() << ",\"validate\":" << p.validate.count()
+          << ",\"index\":" << p.index.count() << "},\"loadNs\":" << s.load.count() << ",\"loads\":" << s.loads
+          << ",\"reloads\":" << s.reloads << ",\"queries\":" << s.queries
+          << ",\"queryTotalNs\":" << s.queryTotal.count() << ",\"queryMaxNs\":" << s.queryMax.count() << "}";
+    }
+    out << "]}";
+    return out.str();
+  }
+  out << std::fixed << std::setprecision(3);
+  for (const auto &s : stats) {
+    const auto &p = s.parse;
+    out << s.config << ": ";
+    if (!s.loaded) {
+      out << "not loaded";
+    } else {
+      out << p.file_size << " bytes, " << p.rows << " rows x " << p.columns << " columns"
+          << (p.from_snapshot ? " from snapshot" : "") << "; open " << Millis(p.open) << " ms, read "
+          << Millis(p.read) << " ms, split rows " << Millis(p.split_rows) << " ms, split columns "
+          << Millis(p.split_columns) << " ms, validate " << Millis(p.validate) << " ms, index " << Millis(p.index)
+          << " ms; load " << Millis(s.load) << " ms";
+    }
+    out << " (" << s.loads << " loads, " << s.reloads << " reloads); " << s.queries << " queries";
+    if (s.queries > 0) {
+      out << ", avg " << Micros(s.queryTotal) / static_cast<double>(s.queries) << " us, max " << Micros(s.queryMax)
+          << " us";
+    }
+    out << "\n";
+  }
+  return out.str();
+}
+
 EventListenerPtr RFConfigManager::CreateConfiguratorImpl(const std::string &config) {
   size_t pos = config.find_last_of(".");
   if (pos == std::string::npos) {
@@ -158,4 +595,114 @@ EventListenerPtr RFConfigManager::CreateConfiguratorImpl(const std::string &conf
     throw std::runtime_error("RFConfigManager::CreateConfiguratorImpl: Unsupported file extension");
   }
   return it->second(config);
-}
\ No newline at end of file
+}
+
+void RFConfigManager::EnableHotReload() {
+#ifdef __linux__
+  if (mWatchFd >= 0) {
+    return;
+  }
+  mWatchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (mWatchFd < 0) {
+    throw std::runtime_error("RFConfigManager::EnableHotReload: Failed to initialize inotify");
+  }
+  for (const auto &[config, listener] : *mPublisher.GeActivetListeners()) {
+    WatchConfig(config);
+  }
+#endif
+}
+
+void RFConfigManager::DisableHotReload() {
+#ifdef __linux__
+  if (mWatchFd >= 0) {
+    ::close(mWatchFd);
+  }
+#endif
+  mWatchFd = -1;
+  mWatchOverflow = false;
+  mWatches.clear();
+  mRetryReload.clear();
+}
+
+void RFConfigManager::WatchConfig(const std::string &config) {
+#ifdef __linux__
+  // watch the directory, not the file: editors and WriteToCSV replace the file by renaming over it
+  std::filesystem::path path(config);
+  auto dir = path.parent_path().empty() ? std::filesystem::path(".") : path.parent_path();
+  int wd = inotify_add_watch(mWatchFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+  if (wd < 0) {
+    throw std::runtime_error("RFConfigManager::WatchConfig: Failed to watch " + dir.string());
+  }
+  mWatches[wd][path.filename().string()] = config;
+#endif
+}
+
+std::vector<std::string> RFConfigManager::CollectChangedConfigs() {
+  std::set<std::string> changed(mRetryReload.begin(), mRetryReload.end());
+  mRetryReload.clear();
+  bool checkAll = mWatchFd < 0;
+#ifdef __linux__
+  if (mWatchFd >= 0) {
+    alignas(inotify_event) char buffer[16 * 1024];
+    ssize_t length;
+    while ((length = ::read(mWatchFd, buffer, sizeof(buffer))) > 0) {
+      for (char *ptr = buffer; ptr < buffer + length;) {
+        auto *event = reinterpret_cast<inotify_event *>(ptr);
+        ptr += sizeof(inotify_event) + event->len;
+        if (event->mask & IN_Q_OVERFLOW) {
+          mWatchOverflow = true;
+          continue;
+        }
+        auto dir = mWatches.find(event->wd);
+        if (dir == mWatches.end() || event->len == 0) {
+          continue;
+        }
+        auto file = dir->second.find(event->name);
+        if (file != dir->second.end()) {
+          changed.insert(file->second);
+        }
+      }
+    }
+  }
+  // dropped events: fall back to checking every file once
+  checkAll = checkAll || std::exchange(mWatchOverflow, false);
+#endif
+  if (checkAll) {
+    for (const auto &[config, listener] : *mPublisher.GeActivetListeners()) {
+      changed.insert(config);
+    }
+  }
+  return {changed.begin(), changed.end()};
+}
+
+std::vector<ConfigReload> RFConfigManager::ReloadChanged() {
+  std::vector<ConfigReload> reloads;
+  std::string errors;
+  auto listeners = mPublisher.GeActivetListeners();
+  for (const auto &config : CollectChangedConfigs()) {
+    auto it = listeners->find(config);
+    if (it == listeners->end()) {
+      continue;
+    }
+    auto configurator = std::dynamic_pointer_cast<ConfiguratorListener>(it->second);
+    if (!configurator) {
+      continue;
+    }
+    // a file caught mid-edit fails to parse; keep its old table and try again next time
+    try {
+      QuerySequence sequence{"Unused, Just a placeholder"};
+      configurator->HandleEvent(EventType::CONFIG_RELOAD, sequence);
+    } catch (const std::exception &e) {
+      mRetryReload.push_back(config);
+      errors += (errors.empty() ? "" : "; ") + config + ": " + e.what();
+      continue;
+    }
+    if (configurator->GetLastReload()) {
+      reloads.push_back(*configurator->GetLastReload());
+    }
+  }
+  if (!errors.empty()) {
+    throw std::runtime_error("RFConfigManager::ReloadChanged: " + errors);
+  }
+  return reloads;
+}
@@ -8,12 +8,42 @@ using RFStimMap = std::unordered_map<std::string, RF_STIM_DEF>;
 class NRFStimPri {
 public:
   RFStimMap mStimMap;
-  void Cleanup() { RFStimMap().swap(mStimMap); }
+  std::shared_ptr<StimTable> mStimTable = std::make_shared<StimTable>(); // rows of every stim in mStimMap
+  void Cleanup() {
+    RFStimMap().swap(mStimMap);
+    mStimTable = std::make_shared<StimTable>();
+  }
   void ReLoadStim() {
     for (auto &[StimName, StimObject] : mStimMap) {
       StimObject.ReLoadStim();
     }
   }
+  // Cached lists are taken from the registry; the rest are fetched in one batch query.
+  void ResolveFreqLists(const std::vector<std::string> &stimNames, const std::string &flistFile) {
+    auto &registry = FreqTableRegistry::GetInstance();
+    std::vector<std::string> missNames;
+    std::vector<std::string> flistNames;
+    for (const auto &stimName : stimNames) {
+      auto &stim = *mStimMap.at(stimName).m_stim;
+      if (auto table = registry.Find(flistFile, stim.FreqListName())) {
+        stim.SetFreqTable(std::move(table));
+      } else {
+        missNames.push_back(stimName);
+        flistNames.push_back(stim.FreqListName());
+      }
+    }
+    if (missNames.empty())
+      return;
+    auto generation = registry.GetGeneration(flistFile);
+    auto flists = RFUTILS::DoBatchQuery(flistFile, flistNames);
+    for (size_t i = 0; i < missNames.size(); ++i) {
+      if (!flists.IsFound(i)) {
+        throw std::runtime_error("Not Found Such FreqListName: " + flistNames[i]);
+      }
+      mStimMap.at(missNames[i]).m_stim->SetFreqTable(
+          registry.Share(flistFile, flistNames[i], flists.Row(i)[1], generation));
+    }
+  }
 };
 NRFStim::NRFStim() : m_pri(std::make_shared<NRFStimPri>()) {}
 
@@ -21,18 +51,53 @@ NRFStim::~NRFStim() { m_pri->Cleanup(); }
 
 RF_STIM_DEF &NRFStim::Config(const std::string &stimName) {
   auto stimFile = SettingManager::GetInstance().GetPropOf("Resource", "StimFile");
-  auto stimResult = RFUTILS::DoQuery(stimFile, stimName);
-  if (stimResult.empty())
+  // the fields view the config snapshot kept alive by queryOwner; the stim table interns its own copy
+  QuerySequence stimResult{stimName};
+  RFConfigManager::GetInstance().OnQuery(stimFile, stimResult);
+  if (stimResult.queryResult.empty())
     throw std::runtime_error("Not find such stimName: " + stimName);
 
   if (m_pri->mStimMap.find(stimName) == m_pri->mStimMap.end()) {
     auto flistFile = SettingManager::GetInstance().GetPropOf("Resource", "FreqListFile");
-    m_pri->mStimMap.emplace(stimName, RF_STIM_DEF{stimResult, flistFile});
+    m_pri->mStimMap.emplace(stimName, RF_STIM_DEF{m_pri->mStimTable, stimResult.queryResult, flistFile});
   }
 
   return m_pri->mStimMap.at(stimName);
 }
 
+void NRFStim::ConfigAll(const std::vector<std::string> &stimNames) {
+  auto stimFile = SettingManager::GetInstance().GetPropOf("Resource", "StimFile");
+  BatchQueryResult stims;
+  RFConfigManager::GetInstance().OnBatchQuery(stimFile, stimNames, stims);
+  std::string missing;
+  for (size_t i = 0; i < stims.size(); ++i) {
+    if (!stims.IsFound(i)) {
+      missing += (missing.empty() ? "" : ", ") + stimNames[i];
+    }
+  }
+  if (!missing.empty())
+    throw std::runtime_error("Not find such stimName: " + missing);
+
+  auto flistFile = SettingManager::GetInstance().GetPropOf("Resource", "FreqListFile");
+  std::vector<std::string> created;
+  for (size_t i = 0; i < stims.size(); ++i) {
+    if (m_pri->mStimMap.find(stimNames[i]) != m_pri->mStimMap.end())
+      continue;
+    m_pri->mStimMap.emplace(stimNames[i], RF_STIM_DEF{m_pri->mStimTable, stims.Row(i), flistFile});
+    created.push_back(stimNames[i]);
+  }
+  m_pri->ResolveFreqLists(created, flistFile);
+}
+
+std::vector<std::string> NRFStim::GetStimsOnPin(const std::string &pin) const {
+  const auto &table = *m_pri->mStimTable;
+  std::vector<std::string> stimNames;
+  for (auto row : table.FindRows(StimTable::Field::Pin, pin)) {
+    stimNames.push_back(table.Get(row, StimTable::Field::Name).Str());
+  }
+  return stimNames;
+}
+
 void NRFStim::Restore() { m_pri->ReLoadStim(); }
 void NRFStim::Cleanup() { m_pri->Cleanup(); }
 
@@ -42,10 +107,33 @@ RF_STIM_DEF::RF_STIM_DEF(const std::vector<std::string> &stimDefs, const std::st
   m_stim->SetFreqListFile(flist);
 }
 
+RF_STIM_DEF::RF_STIM_DEF(const InternedRow &stimDefs, const std::string &flist)
+    : m_stim(std::make_shared<StimDefInner>(stimDefs)),
+      m_impl(std::make_shared<RFStimImpl>(m_stim->Type(), m_stim->Pin())) {
+  m_stim->SetFreqListFile(flist);
+}
+
+RF_STIM_DEF::RF_STIM_DEF(const std::shared_ptr<StimTable> &table, const InternedRow &stimDefs,
+                         const std::string &flist)
+    : m_stim(std::make_shared<StimDefInner>(table, stimDefs)),
+      m_impl(std::make_shared<RFStimImpl>(m_stim->Type(), m_stim->Pin())) {
+  m_stim->SetFreqListFile(flist);
+}
+
+RF_STIM_DEF::RF_STIM_DEF(const std::shared_ptr<StimTable> &table, std::span<const std::string_view> stimDefs,
+                         const std::string &flist)
+    : m_stim(std::make_shared<StimDefInner>(table, stimDefs)),
+      m_impl(std::make_shared<RFStimImpl>(m_stim->Type(), m_stim->Pin())) {
+  m_stim->SetFreqListFile(flist);
+}
+
 RF_STIM_DEF::~RF_STIM_DEF() { mIsLoaded = false; }
 RF_STIM_DEF &RF_STIM_DEF::Load() {
+  // always asks the registry: a cached list is a hash lookup, and a list invalidated by a config reload is
+  // parsed again instead of the stim keeping the table it resolved before
   m_stim->UpdateFreqListValuesByName(m_stim->FreqListName());
-  m_impl->SetDefaultSettings(m_stim->Type(), m_stim->Frequencies(), m_stim->Power());
+  auto powers = m_stim->Power();
+  m_impl->SetDefaultSettings(m_stim->Type(), m_stim->Frequencies(), std::vector<double>(powers.begin(), powers.end()));
   if (m_stim->Type() == "MOD") {
     m_wave = std::make_shared<WaveFileImpl>(m_stim->WaveFile());
     m_wave->LoadWaveToDDR();
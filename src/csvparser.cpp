@@ -1,5 +1,65 @@
 #include "kits/csvparser.hpp"
+#include "kits/threadpool.hpp"
 #include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+
+#if !defined(_WIN32) && (defined(__x86_64__) || defined(__i386__)) &&         \
+    (defined(__GNUC__) || defined(__clang__))
+#define CSV_SIMD_SPLIT
+#include <immintrin.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MMapIO::MMapIO(const std::string &filename) {
+#ifdef _WIN32
+  throw std::runtime_error("Memory mapped IO is not supported on this platform.");
+#else
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Failed to open file.");
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw std::runtime_error("Failed to stat file.");
+  }
+  m_size = static_cast<size_t>(st.st_size);
+  // an empty file cannot be mapped, leave the view empty and let the parser
+  // report it the same way as the stream backend
+  if (m_size > 0) {
+    void *addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("Failed to map file.");
+    }
+    ::madvise(addr, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const char *>(addr);
+  }
+  ::close(fd);
+#endif
+}
+
+MMapIO::~MMapIO() {
+#ifndef _WIN32
+  if (m_data)
+    ::munmap(const_cast<char *>(m_data), m_size);
+#endif
+}
+
+size_t MMapIO::Read(char *buffer, size_t filesize) {
+  size_t count = std::min(filesize, m_size - m_read_pos);
+  std::copy_n(m_data + m_read_pos, count, buffer);
+  m_read_pos += count;
+  return count;
+}
 
 namespace CSVUtils {
 inline namespace FileOperations {
@@ -26,12 +86,14 @@ std::unique_ptr<BaseIO> CreateFileHandler(std::ifstream &in) {
     throw std::runtime_error("Invalid file handle.");
   return std::make_unique<IStreamIO>(in);
 }
+std::unique_ptr<BaseIO> CreateMappedFileHandler(const std::string &filename) {
+  return std::make_unique<MMapIO>(filename);
+}
 }; // namespace FileOperations
 
-inline namespace ParseOperations {
-std::vector<std::string_view> SplitRow(std::string_view row, const char &ch) {
-  std::vector<std::string_view> tmp;
-  tmp.reserve(row.size() / 2);
+namespace {
+void SplitRowScalar(std::string_view row, const char &ch,
+                    std::vector<std::string_view> &tmp) {
   size_t start = 0;
 
   bool IsNewLine = false;
@@ -41,7 +103,7 @@ std::vector<std::string_view> SplitRow(std::string_view row, const char &ch) {
   for (size_t pos = 0; pos < row.size(); pos++) {
 #ifdef _WIN32
     IsNewLine =
-        (row[pos] == '\r' && pos + 1 < str.size() && row[pos + 1] == '\n');
+        (row[pos] == '\r' && pos + 1 < row.size() && row[pos + 1] == '\n');
     IsStartPosition = (row[pos] == start && row[pos] == ch);
 #else
     IsNewLine = (row[pos] == '\n');
@@ -57,13 +119,143 @@ std::vector<std::string_view> SplitRow(std::string_view row, const char &ch) {
       }
     }
   }
-  IsEndPosition = (start == row.size() && row[start - 1] == ch && ch != '\n');
+  IsEndPosition = (start == row.size() && start > 0 && row[start - 1] == ch &&
+                   ch != '\n');
   // process the last character: empty or not
   if (start < row.size() || IsEndPosition) {
     tmp.emplace_back(row.substr(start));
   }
+}
+
+#ifdef CSV_SIMD_SPLIT
+// Vectorized variants look for `ch` and '\n' a block at a time and replay the
+// scalar per-delimiter logic only on the hits, so the output is identical to
+// SplitRowScalar (including the byte skipped after every '\n').
+struct SplitState {
+  std::string_view row;
+  char ch;
+  std::vector<std::string_view> &out;
+  size_t start = 0;
+  size_t next = 0; // first position still to be examined
+};
+
+inline void OnDelimiter(SplitState &s, size_t pos) {
+  const char c = s.row[pos];
+  const bool IsNewLine = (c == '\n');
+  const bool IsStartPosition = (pos == s.start && c == s.ch && !IsNewLine);
+  if (pos > s.start || IsStartPosition) {
+    s.out.emplace_back(s.row.substr(s.start, pos - s.start));
+  }
+  s.start = pos + (c == '\r' ? 2 : 1);
+  s.next = pos + (IsNewLine ? 2 : 1);
+}
+
+inline void ScanMask(SplitState &s, uint32_t mask, size_t base) {
+  while (mask) {
+    size_t pos = base + __builtin_ctz(mask);
+    mask &= mask - 1;
+    if (pos >= s.next)
+      OnDelimiter(s, pos);
+  }
+}
+
+inline void ScanTail(SplitState &s, size_t from) {
+  for (size_t pos = std::max(from, s.next); pos < s.row.size(); ++pos) {
+    if (s.row[pos] == s.ch || s.row[pos] == '\n') {
+      OnDelimiter(s, pos);
+      pos = s.next - 1;
+    }
+  }
+}
+
+inline void Finish(SplitState &s) {
+  bool IsEndPosition = (s.start == s.row.size() && s.start > 0 &&
+                        s.row[s.start - 1] == s.ch && s.ch != '\n');
+  if (s.start < s.row.size() || IsEndPosition) {
+    s.out.emplace_back(s.row.substr(s.start));
+  }
+}
+
+__attribute__((target("avx2"))) void
+SplitRowAVX2(std::string_view row, const char &ch,
+             std::vector<std::string_view> &tmp) {
+  SplitState s{row, ch, tmp};
+  const __m256i delim = _mm256_set1_epi8(ch);
+  const __m256i newline = _mm256_set1_epi8('\n');
+  size_t base = 0;
+  for (; base + 32 <= row.size(); base += 32) {
+    __m256i block = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(row.data() + base));
+    __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(block, delim),
+                                   _mm256_cmpeq_epi8(block, newline));
+    ScanMask(s, static_cast<uint32_t>(_mm256_movemask_epi8(hits)), base);
+  }
+  ScanTail(s, base);
+  Finish(s);
+}
+
+__attribute__((target("sse4.2"))) void
+SplitRowSSE42(std::string_view row, const char &ch,
+              std::vector<std::string_view> &tmp) {
+  SplitState s{row, ch, tmp};
+  const __m128i delim = _mm_set1_epi8(ch);
+  const __m128i newline = _mm_set1_epi8('\n');
+  size_t base = 0;
+  for (; base + 16 <= row.size(); base += 16) {
+    __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(row.data() + base));
+    __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, delim),
+                                _mm_cmpeq_epi8(block, newline));
+    ScanMask(s, static_cast<uint32_t>(_mm_movemask_epi8(hits)), base);
+  }
+  ScanTail(s, base);
+  Finish(s);
+}
+#endif
+
+using SplitRowFn = void (*)(std::string_view, const char &,
+                            std::vector<std::string_view> &);
+
+SplitRowFn SelectSplitRow() {
+#ifdef CSV_SIMD_SPLIT
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return SplitRowAVX2;
+  if (__builtin_cpu_supports("sse4.2"))
+    return SplitRowSSE42;
+#endif
+  return SplitRowScalar;
+}
+} // namespace
+
+inline namespace ParseOperations {
+std::vector<std::string_view> SplitRow(std::string_view row, const char &ch) {
+  std::vector<std::string_view> tmp;
+  SplitRowInto(row, ch, tmp);
   return tmp;
 }
+void SplitRowInto(std::string_view row, const char &ch,
+                  std::vector<std::string_view> &out) {
+  static const SplitRowFn split = SelectSplitRow();
+  out.clear();
+  split(row, ch, out);
+}
+void SplitFieldsInto(std::string_view row, const char &ch, size_t limit,
+                     std::vector<std::string_view> &out) {
+  out.clear();
+  size_t start = 0;
+  while (out.size() < limit) {
+    size_t pos = row.find(ch, start);
+    if (pos == std::string_view::npos) {
+      // the last field is empty only after a trailing delimiter, as in SplitRow
+      if (start < row.size() || (start > 0 && start == row.size()))
+        out.emplace_back(row.substr(start));
+      break;
+    }
+    out.emplace_back(row.substr(start, pos - start));
+    start = pos + 1;
+  }
+}
 std::vector<std::string_view> SplitSkipHeaderRow(std::string_view row,
                                                  const char &ch) {
   auto pos = row.find_first_of(ch);
@@ -73,6 +265,30 @@ std::string_view SplitHeaderRow(std::string_view header, const char &ch) {
   auto pos = header.find_first_of(ch);
   return header.substr(0, pos);
 }
+size_t FindRowBoundary(std::string_view buffer, size_t from) {
+  // A '\n' that follows a non-newline byte always ends a row in SplitRow, and
+  // when the byte after it is not a newline either, splitting the remainder
+  // on its own yields exactly the rows a single pass would.
+  for (size_t pos = std::max<size_t>(from, 1); pos + 1 < buffer.size(); ++pos) {
+    pos = buffer.find('\n', pos);
+    if (pos == std::string_view::npos || pos + 1 >= buffer.size())
+      break;
+    if (buffer[pos - 1] != '\n' && buffer[pos + 1] != '\n')
+      return pos + 1;
+  }
+  return std::string_view::npos;
+}
+size_t FindLastRowBoundary(std::string_view buffer) {
+  for (size_t pos = buffer.size() - std::min<size_t>(buffer.size(), 2);
+       pos > 0; --pos) {
+    pos = buffer.rfind('\n', pos);
+    if (pos == 0 || pos == std::string_view::npos)
+      break;
+    if (buffer[pos - 1] != '\n' && buffer[pos + 1] != '\n')
+      return pos + 1;
+  }
+  return std::string_view::npos;
+}
 }; // namespace ParseOperations
 }; // namespace CSVUtils
 
@@ -90,7 +306,9 @@ FileHandle::~FileHandle() {
 }
 
 FileManager::FileManager(const std::string &filename)
-    : m_file_handle(std::make_unique<FileHandle>(filename)) {}
+    : m_file_handle(std::make_unique<FileHandle>(filename)) {
+  OpenSourceFile(filename);
+}
 
 void FileManager::OpenSourceFile(const std::string &filename) {
   if (!m_file_handle)
@@ -99,137 +317,801 @@ void FileManager::OpenSourceFile(const std::string &filename) {
       CSVUtils::FileOperations::CalFileByteSize(m_file_handle->GetHandle());
 }
 
-std::unique_ptr<BaseIO> FileManager::CreateFileHandler() {
+std::unique_ptr<BaseIO> FileManager::CreateFileHandler(IOMode mode) {
+  if (mode == IOMode::MemoryMapped)
+    return CSVUtils::FileOperations::CreateMappedFileHandler(
+        m_file_handle->GetHandleContext());
   return CSVUtils::FileOperations::CreateFileHandler(
       m_file_handle->GetHandle());
 }
 
+size_t ColumnStore::RowView::size() const noexcept {
+  size_t count = 0;
+  while (count < m_store->ColumnCount() &&
+         m_store->m_columns[count][m_row].IsValid()) {
+    ++count;
+  }
+  return count;
+}
+
+std::vector<std::string_view> ColumnStore::RowView::ToVector() const {
+  std::vector<std::string_view> fields;
+  CopyTo(fields);
+  return fields;
+}
+
+void ColumnStore::RowView::CopyTo(std::vector<std::string_view> &out) const {
+  out.resize(size());
+  for (size_t col = 0; col < out.size(); ++col) {
+    out[col] = (*this)[col];
+  }
+}
+
+void ColumnStore::Reset(std::string_view source, size_t columns) {
+  if (source.size() >= FieldSpan::npos)
+    throw std::runtime_error("Source too large for columnar offsets.");
+  m_source = source;
+  m_overflow.clear();
+  m_columns.resize(columns);
+  for (auto &column : m_columns) {
+    column.clear();
+  }
+  m_row_count = 0;
+}
+
+void ColumnStore::Reserve(size_t rows) {
+  for (auto &column : m_columns) {
+    column.reserve(rows);
+  }
+}
+
+void ColumnStore::AppendRow(const std::vector<std::string_view> &fields) {
+  Widen(fields.size());
+  for (size_t col = 0; col < m_columns.size(); ++col) {
+    m_columns[col].push_back(col < fields.size() ? MakeSpan(fields[col])
+                                                 : FieldSpan{});
+  }
+  ++m_row_count;
+}
+
+void ColumnStore::Append(const ColumnStore &other) {
+  if (other.m_source.data() != m_source.data() || !other.m_overflow.empty())
+    throw std::runtime_error("Cannot append columns of a different source.");
+  Widen(other.ColumnCount());
+  for (size_t col = 0; col < m_columns.size(); ++col) {
+    auto &column = m_columns[col];
+    if (col < other.ColumnCount()) {
+      const auto &spans = other.m_columns[col];
+      column.insert(column.end(), spans.begin(), spans.end());
+    } else {
+      column.resize(column.size() + other.m_row_count);
+    }
+  }
+  m_row_count += other.m_row_count;
+}
+
+void ColumnStore::Assign(const std::vector<std::vector<std::string_view>> &rows) {
+  // the old overflow may still back some of the incoming views, so build the
+  // new one aside and swap it in afterwards
+  std::string overflow;
+  std::vector<std::vector<FieldSpan>> columns;
+  auto place = [this, &overflow](std::string_view field) {
+    auto begin = std::less_equal<const char *>{}(m_source.data(), field.data());
+    auto end = std::less_equal<const char *>{}(field.data() + field.size(),
+                                               m_source.data() + m_source.size());
+    if (begin && end)
+      return MakeSpan(field);
+    if (m_source.size() + overflow.size() + field.size() >= FieldSpan::npos)
+      throw std::runtime_error("Source too large for columnar offsets.");
+    FieldSpan span{static_cast<uint32_t>(m_source.size() + overflow.size()),
+                   static_cast<uint32_t>(field.size())};
+    overflow.append(field);
+    return span;
+  };
+  for (size_t row = 0; row < rows.size(); ++row) {
+    if (rows[row].size() > columns.size())
+      columns.resize(rows[row].size(), std::vector<FieldSpan>(row));
+    for (size_t col = 0; col < columns.size(); ++col) {
+      columns[col].push_back(col < rows[row].size() ? place(rows[row][col])
+                                                    : FieldSpan{});
+    }
+  }
+  m_overflow.swap(overflow);
+  m_columns.swap(columns);
+  m_row_count = rows.size();
+}
+
+void ColumnStore::Clear() {
+  m_source = {};
+  std::string().swap(m_overflow);
+  std::vector<std::vector<FieldSpan>>().swap(m_columns);
+  m_row_count = 0;
+}
+
+std::string_view ColumnStore::Text(const FieldSpan &span) const noexcept {
+  if (!span.IsValid())
+    return {};
+  if (span.offset < m_source.size())
+    return m_source.substr(span.offset, span.length);
+  return std::string_view(m_overflow)
+      .substr(span.offset - m_source.size(), span.length);
+}
+
+std::string_view ColumnStore::Field(size_t row, size_t col) const {
+  if (col >= m_columns.size() || row >= m_row_count)
+    throw std::out_of_range("Field index out of range.");
+  return Text(m_columns[col][row]);
+}
+
+std::vector<std::vector<std::string_view>> ColumnStore::ToRows() const {
+  std::vector<std::vector<std::string_view>> rows(m_row_count);
+  for (size_t row = 0; row < m_row_count; ++row) {
+    rows[row] = Row(row).ToVector();
+  }
+  return rows;
+}
+
+FieldSpan ColumnStore::MakeSpan(std::string_view field) const {
+  auto offset = field.data() - m_source.data();
+  if (offset < 0 || static_cast<size_t>(offset) + field.size() > m_source.size())
+    throw std::runtime_error("Field does not belong to the parsed buffer.");
+  return FieldSpan{static_cast<uint32_t>(offset),
+                   static_cast<uint32_t>(field.size())};
+}
+
+void ColumnStore::Widen(size_t columns) {
+  if (columns > m_columns.size())
+    m_columns.resize(columns, std::vector<FieldSpan>(m_row_count));
+}
+
+uint64_t KeyIndex::Hash(std::string_view key) noexcept {
+  // FNV-1a, stable across runs and builds
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : key) {
+    hash = (hash ^ c) * 1099511628211ull;
+  }
+  return hash;
+}
+
+void KeyIndex::Build(const ColumnStore &table, size_t column) {
+  auto keys = table.Column(column);
+  size_t capacity = 16;
+  while (capacity < keys.size() * 2) {
+    capacity <<= 1;
+  }
+  m_slots.assign(capacity, 0);
+  m_table = &table;
+  m_column = column;
+  m_size = 0;
+  if (keys.size() >= 0xFFFFFFFFu)
+    throw std::runtime_error("Too many rows for key index.");
+
+  const size_t mask = capacity - 1;
+  for (size_t row = 0; row < keys.size(); ++row) {
+    auto key = keys[row];
+    uint64_t hash = Hash(key);
+    uint64_t tag = hash & 0xFFFFFFFF00000000ull;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+      uint64_t entry = m_slots[slot];
+      if (entry == 0) {
+        m_slots[slot] = tag | (row + 1);
+        ++m_size;
+        break;
+      }
+      // duplicate keys resolve to their first row, like a linear scan would
+      if ((entry & 0xFFFFFFFF00000000ull) == tag &&
+          keys[(entry & 0xFFFFFFFFu) - 1] == key)
+        break;
+    }
+  }
+}
+
+size_t KeyIndex::Find(std::string_view key) const noexcept {
+  if (!m_table || m_slots.empty())
+    return npos;
+  auto keys = m_table->Column(m_column);
+  uint64_t hash = Hash(key);
+  uint64_t tag = hash & 0xFFFFFFFF00000000ull;
+  const size_t mask = m_slots.size() - 1;
+  for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+    uint64_t entry = m_slots[slot];
+    if (entry == 0)
+      return npos;
+    size_t row = (entry & 0xFFFFFFFFu) - 1;
+    if ((entry & 0xFFFFFFFF00000000ull) == tag && keys[row] == key)
+      return row;
+  }
+}
+
+void KeyIndex::Clear() {
+  m_table = nullptr;
+  m_size = 0;
+  std::vector<uint64_t>().swap(m_slots);
+}
+
+TableDiff ParserImpl::Reconcile(const ParserImpl &previous) {
+  TableDiff diff;
+  const size_t column =
+      previous.m_key_index.IsBuilt() ? previous.m_key_index.GetColumn() : 0;
+  if (column >= m_table.ColumnCount() ||
+      m_table.ColumnCount() != previous.m_table.ColumnCount())
+    throw std::runtime_error("Reloaded table does not match the columns.");
+  // secondary indices carry over by column; their groups view the table they
+  // were built on, so they are rebuilt rather than copied
+  for (const auto &[col, index] : previous.m_secondary_indices) {
+    if (!HasSecondaryIndex(col))
+      BuildSecondaryIndex(col);
+  }
+
+  auto SameRow = [this, &previous](size_t row, size_t old_row) {
+    auto current = m_table.Row(row);
+    auto before = previous.m_table.Row(old_row);
+    for (size_t col = 0; col < current.size(); ++col) {
+      if (current[col] != before[col])
+        return false;
+    }
+    return true;
+  };
+
+  auto keys = m_table.Column(column);
+  auto old_keys = previous.m_table.Column(column);
+  bool same_order = keys.size() == old_keys.size();
+  for (size_t row = 0; same_order && row < keys.size(); ++row) {
+    same_order = keys[row] == old_keys[row];
+  }
+
+  if (same_order) {
+    // rows kept their place: compare in lockstep and keep the old index
+    for (size_t row = 0; row < keys.size(); ++row) {
+      if (!SameRow(row, row))
+        diff.changed.emplace_back(keys[row]);
+    }
+    if (!m_key_index.IsBuilt() && previous.m_key_index.IsBuilt()) {
+      m_key_index = previous.m_key_index;
+      m_key_index.Rebind(m_table);
+    }
+    return diff;
+  }
+
+  if (!m_key_index.IsBuilt() || m_key_index.GetColumn() != column) {
+    PhaseTimer timer(m_stats.index);
+    m_key_index.Build(m_table, column);
+  }
+  // previous may still be serving readers, so it is only ever read here
+  KeyIndex scratch;
+  const KeyIndex *old_index = &previous.m_key_index;
+  if (!old_index->IsBuilt()) {
+    scratch.Build(previous.m_table, column);
+    old_index = &scratch;
+  }
+  // duplicate keys resolve to their first row on both sides, as FindRow does
+  for (size_t row = 0; row < keys.size(); ++row) {
+    if (m_key_index.Find(keys[row]) != row)
+      continue;
+    size_t old_row = old_index->Find(keys[row]);
+    if (old_row == KeyIndex::npos)
+      diff.added.emplace_back(keys[row]);
+    else if (!SameRow(row, old_row))
+      diff.changed.emplace_back(keys[row]);
+  }
+  for (size_t row = 0; row < old_keys.size(); ++row) {
+    if (old_index->Find(old_keys[row]) == row &&
+        m_key_index.Find(old_keys[row]) == KeyIndex::npos)
+      diff.removed.emplace_back(old_keys[row]);
+  }
+  return diff;
+}
+
 ParserImpl::ParserImpl() { Initialize(); }
 
 void ParserImpl::SetColumnNames(const std::vector<std::string_view> &colNames) {
   m_col_names = colNames;
+  m_source_col_names = colNames;
+  m_projection.clear();
 }
 
-void ParserImpl::ParseRows(const std::unique_ptr<BaseIO> &io, size_t filesize) {
-  m_read_buffer.resize(filesize);
-  io->Read(m_read_buffer.data(), filesize);
-  if (m_read_buffer.size() == 0)
+void ParserImpl::SetProjection(const std::vector<std::string_view> &columns) {
+  std::vector<size_t> projection;
+  for (auto name : columns) {
+    auto it = std::find(m_source_col_names.begin(), m_source_col_names.end(),
+                        name);
+    if (it == m_source_col_names.end())
+      throw std::runtime_error("Unknown column: " + std::string(name));
+    projection.push_back(static_cast<size_t>(it - m_source_col_names.begin()));
+  }
+  std::sort(projection.begin(), projection.end());
+  if (std::adjacent_find(projection.begin(), projection.end()) !=
+      projection.end())
+    throw std::runtime_error("Duplicate column names provided.");
+
+  m_col_names.clear();
+  for (size_t column : projection) {
+    m_col_names.push_back(m_source_col_names[column]);
+  }
+  // keeping every column is no projection at all
+  if (projection.size() == m_source_col_names.size())
+    projection.clear();
+  m_projection = std::move(projection);
+  if (columns.empty())
+    m_col_names = m_source_col_names;
+}
+
+void ParserImpl::ParseRows(std::unique_ptr<BaseIO> io, size_t filesize) {
+  LoadBuffer(std::move(io), filesize);
+  PhaseTimer timer(m_stats.split_rows);
+  m_rows = CSVUtils::ParseOperations::SplitSkipHeaderRow(m_buffer, '\n');
+}
+
+void ParserImpl::LoadBuffer(std::unique_ptr<BaseIO> io, size_t filesize) {
+  m_stats = {};
+  PhaseTimer timer(m_stats.read);
+  m_key_index.Clear();
+  m_secondary_indices.clear();
+  ClearTypedColumns();
+  m_edited = false;
+  if (auto mapped = io->View(); !mapped.empty()) {
+    // parse in place: rows and columns view the mapped pages directly
+    m_source = std::move(io);
+    m_buffer = mapped;
+  } else {
+    m_read_buffer.resize(filesize);
+    io->Read(m_read_buffer.data(), filesize);
+    m_buffer = m_read_buffer;
+  }
+  if (m_buffer.size() == 0)
     throw std::runtime_error("No context.");
-  m_rows = CSVUtils::ParseOperations::SplitSkipHeaderRow(m_read_buffer, '\n');
 }
 
-void ParserImpl::ParseColumns(const std::vector<std::string_view> &rows) {
-  m_data.reserve(rows.size());
+void ParserImpl::ParseColumns(std::span<const std::string_view> rows) {
+  PhaseTimer timer(m_stats.split_columns);
+  m_table.Reset(m_buffer, m_col_names.size());
+  m_table.Reserve(rows.size());
+  std::vector<std::string_view> columns;
+  std::vector<std::string_view> scratch;
   for (size_t i = 0; i < rows.size(); ++i) {
-    auto columns = CSVUtils::ParseOperations::SplitRow(rows[i], ',');
-    if (!m_col_names.empty() && !ValidateColumnSize(columns)) {
-      auto err = std::string("Invalid column size: ") +
-                 std::to_string(columns.size()) + " at row " +
-                 std::to_string(i);
-      throw std::runtime_error(err);
-    }
-    m_data[i] = columns;
+    CheckColumnSize(SplitFields(rows[i], scratch, columns), i);
+    m_table.AppendRow(columns);
   }
+  m_data_stale = true;
 }
 
-void ParserImpl::AsyncParseColumns(const std::vector<std::string_view> &rows,
+void ParserImpl::AsyncParseColumns(std::span<const std::string_view> rows,
                                    size_t workers) {
-  std::vector<std::thread> worker_threads;
-  std::atomic<size_t> counter{0};
-  std::atomic<bool> hasException{false};
-  std::queue<std::exception_ptr> exceptions;
-  m_data.resize(rows.size());
-
-  auto CheckAndSplitRow2Columns = [this, &rows](size_t j) {
-    auto columns = CSVUtils::ParseOperations::SplitRow(rows[j], ',');
-    if (!this->m_col_names.empty() && !ValidateColumnSize(columns)) {
+  PhaseTimer timer(m_stats.split_columns);
+  // blocks of rows are scheduled on the shared pool, each fills its own
+  // partial store and the partials are stitched in order afterwards
+  workers = std::max<size_t>(workers, 1);
+  const size_t block = std::max<size_t>(1, rows.size() / (workers * 4));
+  std::vector<ColumnStore> parts((rows.size() + block - 1) / block);
+
+  ThreadPool::Shared().ParallelFor(
+      parts.size(), 1, [this, &rows, &parts, block](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+          auto &part = parts[b];
+          size_t first = b * block;
+          size_t last = std::min(rows.size(), first + block);
+          part.Reset(m_buffer, m_col_names.size());
+          part.Reserve(last - first);
+          std::vector<std::string_view> columns;
+          std::vector<std::string_view> scratch;
+          for (size_t j = first; j < last; ++j) {
+            CheckColumnSize(SplitFields(rows[j], scratch, columns), j);
+            part.AppendRow(columns);
+          }
+        }
+      });
+
+  m_table.Reset(m_buffer, m_col_names.size());
+  m_table.Reserve(rows.size());
+  for (const auto &part : parts) {
+    m_table.Append(part);
+  }
+  m_data_stale = true;
+}
+
+namespace {
+struct RowChunk {
+  std::vector<std::string_view> rows;
+  ColumnStore table;
+  size_t bad_row = std::string_view::npos;
+  size_t bad_size = 0;
+  std::exception_ptr error;
+  std::chrono::nanoseconds split_rows{0};
+  std::chrono::nanoseconds split_columns{0};
+};
+} // namespace
+
+void ParserImpl::ParseChunks(std::unique_ptr<BaseIO> io, size_t filesize,
+                             size_t workers) {
+  LoadBuffer(std::move(io), filesize);
+  auto body = m_buffer.substr(m_buffer.find_first_of('\n') + 1);
+
+  workers = std::max<size_t>(workers, 1);
+  std::vector<size_t> cuts{0};
+  for (size_t i = 1; i < workers; ++i) {
+    size_t cut = CSVUtils::ParseOperations::FindRowBoundary(
+        body, std::max(cuts.back(), body.size() / workers * i));
+    if (cut == std::string_view::npos)
+      break;
+    if (cut > cuts.back())
+      cuts.push_back(cut);
+  }
+  cuts.push_back(body.size());
+
+  std::vector<RowChunk> chunks(cuts.size() - 1);
+  auto SplitChunk = [this, &body, &cuts, &chunks](size_t c) {
+    auto &chunk = chunks[c];
+    try {
+      {
+        PhaseTimer timer(chunk.split_rows);
+        chunk.rows = CSVUtils::ParseOperations::SplitRow(
+            body.substr(cuts[c], cuts[c + 1] - cuts[c]), '\n');
+      }
+      PhaseTimer timer(chunk.split_columns);
+      chunk.table.Reset(m_buffer, m_col_names.size());
+      chunk.table.Reserve(chunk.rows.size());
+      std::vector<std::string_view> columns;
+      std::vector<std::string_view> scratch;
+      for (size_t j = 0; j < chunk.rows.size(); ++j) {
+        size_t count = SplitFields(chunk.rows[j], scratch, columns);
+        if (!ValidateColumnSize(count)) {
+          chunk.bad_row = j;
+          chunk.bad_size = count;
+          return;
+        }
+        chunk.table.AppendRow(columns);
+      }
+    } catch (...) {
+      chunk.error = std::current_exception();
+    }
+  };
+
+  ThreadPool::Shared().ParallelFor(chunks.size(), 1,
+                                   [&SplitChunk](size_t begin, size_t end) {
+                                     for (size_t c = begin; c < end; ++c) {
+                                       SplitChunk(c);
+                                     }
+                                   });
+
+  // stitch in order; the first failing chunk reports its row globally
+  PhaseTimer timer(m_stats.split_columns);
+  size_t total = 0;
+  for (const auto &chunk : chunks) {
+    // chunks ran side by side, so the slowest one is the phase's wall time
+    m_stats.split_rows = std::max(m_stats.split_rows, chunk.split_rows);
+    m_stats.split_columns = std::max(m_stats.split_columns, chunk.split_columns);
+    if (chunk.error)
+      std::rethrow_exception(chunk.error);
+    if (chunk.bad_row != std::string_view::npos) {
       auto err = std::string("Invalid column size: ") +
-                 std::to_string(columns.size()) + " at row " +
-                 std::to_string(j);
+                 std::to_string(chunk.bad_size) + " at row " +
+                 std::to_string(total + chunk.bad_row);
       throw std::runtime_error(err);
     }
-    return std::vector{columns};
-  };
+    total += chunk.rows.size();
+  }
+  m_rows.clear();
+  m_rows.reserve(total);
+  m_table.Reset(m_buffer, m_col_names.size());
+  m_table.Reserve(total);
+  for (const auto &chunk : chunks) {
+    m_rows.insert(m_rows.end(), chunk.rows.begin(), chunk.rows.end());
+    m_table.Append(chunk.table);
+  }
+  m_data_stale = true;
+}
 
-  for (size_t i = 0; i < workers; ++i) {
-    worker_threads.emplace_back([&counter, &hasException, &exceptions,
-                                 &CheckAndSplitRow2Columns, rows, this] {
-      while (true) {
-        size_t j = counter.fetch_add(1);
-        if (j >= rows.size() || hasException.load())
-          break;
-        try {
-          m_data[j] = CheckAndSplitRow2Columns(j);
-        } catch (...) {
-          exceptions.push(std::current_exception());
-          hasException.store(true);
-        }
+size_t ParserImpl::StreamRows(BaseIO &io, size_t chunksize,
+                              const StreamBatchCallback &on_batch) {
+  std::string buffer(std::max<size_t>(chunksize, 2), '\0');
+  const size_t limit = std::max(buffer.size(), kMaxStreamCarry);
+  std::vector<std::string_view> rows;
+  std::vector<std::string_view> columns;
+  std::vector<std::string_view> scratch;
+  ColumnStore batch;
+  size_t carry = 0;
+  size_t total_bytes = 0;
+  size_t first_row = 0;
+  bool header = true;
+  bool eof = false;
+
+  while (!eof) {
+    if (carry == buffer.size()) { // a single line outgrew the chunk
+      if (buffer.size() >= limit)
+        throw std::runtime_error("No row boundary within " +
+                                 std::to_string(limit) + " bytes at row " +
+                                 std::to_string(first_row));
+      buffer.resize(std::min(buffer.size() * 2, limit));
+    }
+    size_t wanted = buffer.size() - carry;
+    size_t got = io.Read(buffer.data() + carry, wanted);
+    total_bytes += got;
+    eof = got < wanted;
+    std::string_view view(buffer.data(), carry + got);
+
+    size_t body = 0;
+    if (header) {
+      auto pos = view.find_first_of('\n');
+      if (pos == std::string_view::npos && !eof) {
+        carry = view.size();
+        continue;
       }
-    });
-  }
+      body = pos + 1; // same as SplitSkipHeaderRow when there is no newline
+      header = false;
+    }
 
-  for (auto &worker : worker_threads) {
-    worker.join();
-  }
-  if (hasException.load() && !exceptions.empty()) {
-    std::rethrow_exception(exceptions.front());
+    // rows after the last safe boundary may be incomplete, keep them for
+    // the next read; at EOF everything left is one final batch
+    size_t cut = view.size();
+    if (!eof) {
+      auto last = CSVUtils::ParseOperations::FindLastRowBoundary(
+          view.substr(body));
+      cut = last == std::string_view::npos ? body : body + last;
+    }
+
+    if (cut > body) {
+      auto slice = view.substr(body, cut - body);
+      CSVUtils::ParseOperations::SplitRowInto(slice, '\n', rows);
+      batch.Reset(slice, m_col_names.size());
+      for (size_t j = 0; j < rows.size(); ++j) {
+        CheckColumnSize(SplitFields(rows[j], scratch, columns), first_row + j);
+        batch.AppendRow(columns);
+      }
+      if (on_batch && rows.size() > 0)
+        on_batch(batch, first_row);
+      first_row += rows.size();
+    }
+
+    carry = view.size() - cut;
+    std::copy(buffer.begin() + cut, buffer.begin() + view.size(),
+              buffer.begin());
   }
+  if (total_bytes == 0)
+    throw std::runtime_error("No context.");
+  return first_row;
 }
 
 void ParserImpl::Initialize() {
+  ResetParsedState();
+  m_col_names.clear();
+  m_source_col_names.clear();
+  m_projection.clear();
+}
+
+void ParserImpl::ResetParsedState() {
   m_read_buffer = "";
+  m_source.reset();
+  m_buffer = {};
   m_rows.clear();
+  m_key_index.Clear();
+  m_secondary_indices.clear();
+  ClearTypedColumns();
+  m_table.Clear();
   m_data.clear();
-  m_col_names.clear();
+  m_data_stale = true;
+  m_edited = false;
+  m_stats = {};
 }
 
 void ParserImpl::ClearAllCache() {
   std::string().swap(m_read_buffer);
   std::vector<std::string_view>().swap(m_rows);
   std::vector<std::string_view>().swap(m_col_names);
+  std::vector<std::string_view>().swap(m_source_col_names);
+  std::vector<size_t>().swap(m_projection);
   std::vector<std::vector<std::string_view>>().swap(m_data);
+  m_data_stale = true;
+  m_key_index.Clear();
+  m_secondary_indices.clear();
+  ClearTypedColumns();
+  m_table.Clear();
+  m_buffer = {};
+  m_source.reset();
 }
 
+namespace {
+// rows formatted per task; a window of these is written before the next one is
+// formatted, which keeps memory bounded for very large tables
+constexpr size_t kWriteBatchRows = 16384;
+
+void FormatRows(const ColumnStore &table, size_t begin, size_t end,
+                std::string &out) {
+  out.clear();
+  // rows in [begin, end) exist, so fields are read straight from the spans; a
+  // short row ends at its first invalid span, as RowView::size() counts
+  std::vector<const std::vector<FieldSpan> *> columns(table.ColumnCount());
+  for (size_t col = 0; col < columns.size(); ++col) {
+    columns[col] = &table.Column(col).Spans();
+  }
+  for (size_t i = begin; i < end; ++i) {
+    for (size_t col = 0; col < columns.size(); ++col) {
+      const auto &span = (*columns[col])[i];
+      if (!span.IsValid())
+        break;
+      if (col != 0)
+        out.push_back(',');
+      out.append(table.Text(span));
+    }
+    out.push_back('\n');
+  }
+}
+} // namespace
+
 void ParserImpl::WriteToFile(const std::string &filename) {
-  std::ofstream out(filename, std::ios::out);
+  if (!m_projection.empty() || m_trailing_columns)
+    throw std::runtime_error(
+        "Cannot write a table that does not hold every column of its file.");
+  // write aside and rename: readers (and our own mapping of the source) keep
+  // seeing the old file until the new one is complete
+  auto temp = CSVUtils::FileOperations::UniqueTempName(filename);
+  try {
+    WriteRows(temp);
+    std::filesystem::rename(temp, filename);
+  } catch (...) {
+    std::error_code ignored;
+    std::filesystem::remove(temp, ignored);
+    throw;
+  }
+}
+
+void ParserImpl::WriteRows(const std::string &filename) const {
+  std::ofstream out(filename,
+                    std::ios::out | std::ios::binary | std::ios::trunc);
   if (!out.is_open()) {
     throw std::runtime_error("Failed to open file.");
   }
 
-  for (const auto &col : m_col_names) {
-    out << col;
-    if (&col != &m_col_names.back()) {
-      out << ",";
-    }
+  std::string header;
+  for (size_t col = 0; col < m_col_names.size(); ++col) {
+    if (col != 0)
+      header.push_back(',');
+    header.append(m_col_names[col]);
   }
-  out << std::endl;
+  header.push_back('\n');
+  out.write(header.data(), static_cast<std::streamsize>(header.size()));
 
-  for (const auto &row : m_data) {
-    for (const auto &col : row) {
-      out << col;
-      if (&col != &row.back()) {
-        out << ",";
-      }
+  const size_t rows = m_table.RowCount();
+  const size_t batches = (rows + kWriteBatchRows - 1) / kWriteBatchRows;
+  const size_t window =
+      std::max<size_t>(1, ThreadPool::Shared().GetWorkerCount() * 2);
+  std::vector<std::string> buffers(std::min(batches, window));
+  for (size_t first = 0; first < batches && out; first += window) {
+    size_t count = std::min(window, batches - first);
+    ThreadPool::Shared().ParallelFor(
+        count, 1, [this, &buffers, first, rows](size_t begin, size_t end) {
+          for (size_t b = begin; b < end; ++b) {
+            size_t row = (first + b) * kWriteBatchRows;
+            FormatRows(m_table, row, std::min(rows, row + kWriteBatchRows),
+                       buffers[b]);
+          }
+        });
+    for (size_t b = 0; b < count; ++b) {
+      out.write(buffers[b].data(),
+                static_cast<std::streamsize>(buffers[b].size()));
     }
-    out << std::endl;
   }
   out.close();
+  if (!out)
+    throw std::runtime_error("Failed to write file.");
 }
 
 void ParserImpl::OnOperationCallback(OperateStrategyCallback on_operation) {
-  if (on_operation)
-    on_operation(m_data);
+  if (!on_operation)
+    return;
+  RowData();
+  on_operation(m_data);
+  m_table.Assign(m_data);
+  m_data_stale = true;
+  m_edited = true;
+  ClearTypedColumns();
+  if (m_key_index.IsBuilt())
+    m_key_index.Build(m_table, m_key_index.GetColumn());
+  for (auto &[column, index] : m_secondary_indices)
+    index.Build(m_table, column);
+}
+
+void ParserImpl::ClearTypedColumns() {
+  std::lock_guard<std::mutex> lock(m_typed_mutex);
+  m_real_columns.clear();
+  m_index_columns.clear();
+}
+
+size_t ParserImpl::GetColumnIndex(std::string_view name) const {
+  auto it = std::find(m_col_names.begin(), m_col_names.end(), name);
+  if (it == m_col_names.end())
+    throw std::runtime_error("Unknown column: " + std::string(name));
+  return static_cast<size_t>(it - m_col_names.begin());
+}
+
+void ParserImpl::BuildKeyIndex(size_t column) {
+  if (column >= m_table.ColumnCount())
+    throw std::runtime_error("Invalid key column.");
+  PhaseTimer timer(m_stats.index);
+  m_key_index.Build(m_table, column);
+}
+
+ParseStats ParserImpl::GetStats() const noexcept {
+  ParseStats stats = m_stats;
+  stats.rows = m_table.RowCount();
+  stats.columns = m_table.ColumnCount();
+  return stats;
+}
+
+void ParserImpl::RecordOpen(std::chrono::nanoseconds open,
+                            size_t filesize) noexcept {
+  m_stats.open = open;
+  m_stats.file_size = filesize;
 }
 
 std::any ParserImpl::OnQueryCallback(QueryStrategyCallback on_query) {
   if (on_query)
-    return on_query(m_data);
+    return on_query(RowData());
   return std::any{};
 }
 
-bool ParserImpl::ValidateColumnSize(
-    const std::vector<std::string_view> &columns) {
-  return columns.size() == m_col_names.size();
+const std::vector<std::vector<std::string_view>> &ParserImpl::RowData() const {
+  std::lock_guard<std::mutex> lock(m_data_mutex);
+  if (m_data_stale) {
+    m_data = m_table.ToRows();
+    m_data_stale = false;
+  }
+  return m_data;
+}
+
+size_t ParserImpl::SplitFields(std::string_view row,
+                               std::vector<std::string_view> &scratch,
+                               std::vector<std::string_view> &fields) const {
+  const size_t declared = m_source_col_names.size();
+  if (declared == 0 || (m_projection.empty() && !m_trailing_columns)) {
+    CSVUtils::ParseOperations::SplitRowInto(row, ',', fields);
+    return fields.size();
+  }
+  // only the fields up to the last kept column are split; the ones after it
+  // are just counted, and not even that past the declared columns when
+  // trailing ones are allowed
+  const size_t kept = m_projection.empty() ? declared : m_projection.back() + 1;
+  CSVUtils::ParseOperations::SplitFieldsInto(row, ',', kept, scratch);
+  size_t count = scratch.size();
+  if (count == kept) {
+    // every delimiter left opens one more field
+    auto rest = row.substr(static_cast<size_t>(
+        scratch.back().data() + scratch.back().size() - row.data()));
+    if (m_trailing_columns) {
+      for (size_t pos = 0; count < declared &&
+                           (pos = rest.find(',', pos)) != std::string_view::npos;
+           ++pos)
+        ++count;
+    } else {
+      count += static_cast<size_t>(std::count(rest.begin(), rest.end(), ','));
+    }
+  }
+  fields.clear();
+  if (count >= declared) {
+    if (m_projection.empty()) {
+      fields.assign(scratch.begin(), scratch.end());
+    } else {
+      for (size_t column : m_projection) {
+        fields.push_back(scratch[column]);
+      }
+    }
+  }
+  return count;
+}
+
+bool ParserImpl::ValidateColumnSize(size_t count) const noexcept {
+  if (m_source_col_names.empty())
+    return true;
+  // SplitFields counts no further than the declared columns when trailing
+  // ones are allowed
+  return count == m_source_col_names.size();
+}
+
+void ParserImpl::CheckColumnSize(size_t count, size_t row) const {
+  if (!ValidateColumnSize(count)) {
+    auto err = std::string("Invalid column size: ") + std::to_string(count) +
+               " at row " + std::to_string(row);
+    throw std::runtime_error(err);
+  }
 }
 
 ParserStrategy::ParserStrategy()
@@ -253,39 +1135,126 @@ std::any ParserStrategy::OnQueryCallback(QueryStrategyCallback on_query) {
   return m_parser_impl->OnQueryCallback(on_query);
 }
 
-void SynchronousParser::ParseDataFromCSV(const std::unique_ptr<BaseIO> &io,
+size_t ParserStrategy::StreamDataFromCSV(BaseIO &io, size_t chunksize,
+                                         const StreamBatchCallback &on_batch) {
+  return m_parser_impl->StreamRows(io, chunksize, on_batch);
+}
+
+void SynchronousParser::ParseDataFromCSV(std::unique_ptr<BaseIO> io,
                                          size_t filesize) {
   m_parser_impl->ParseRows(std::move(io), filesize);
-  m_parser_impl->ParseColumns(m_parser_impl->GetAllRows());
+  m_parser_impl->ParseColumns(m_parser_impl->GetAllRowsView());
 }
 
 AsynchronousParser::AsynchronousParser(size_t workers)
     : m_thread_workers(workers) {}
 
-void AsynchronousParser::ParseDataFromCSV(const std::unique_ptr<BaseIO> &io,
+void AsynchronousParser::ParseDataFromCSV(std::unique_ptr<BaseIO> io,
                                           size_t filesize) {
   m_parser_impl->ParseRows(std::move(io), filesize);
-  m_parser_impl->AsyncParseColumns(m_parser_impl->GetAllRows(),
+  m_parser_impl->AsyncParseColumns(m_parser_impl->GetAllRowsView(),
                                    m_thread_workers);
 }
 
-void CSVParser::SetParser(ParserMode mode, size_t workers) {
+ChunkedParser::ChunkedParser(size_t workers) : m_thread_workers(workers) {}
+
+void ChunkedParser::ParseDataFromCSV(std::unique_ptr<BaseIO> io,
+                                     size_t filesize) {
+  m_parser_impl->ParseChunks(std::move(io), filesize, m_thread_workers);
+}
+
+std::unique_ptr<ParserStrategy> CSVParser::CreateStrategy(ParserMode mode,
+                                                          size_t workers) {
   switch (mode) {
+  case ParserMode::Chunked:
+    return std::make_unique<ChunkedParser>(workers);
   case ParserMode::Asynchronous:
-    m_parser = std::make_unique<AsynchronousParser>(workers);
-    break;
+    return std::make_unique<AsynchronousParser>(workers);
   case ParserMode::Synchronous:
-    m_parser = std::make_unique<SynchronousParser>();
-    break;
+    return std::make_unique<SynchronousParser>();
   default:
     throw std::runtime_error("Invalid parser mode.");
   }
 }
 
+void CSVParser::SetParser(ParserMode mode, size_t workers) {
+  m_parser = CreateStrategy(mode, workers);
+  m_parser_mode = mode;
+  m_parser_workers = workers;
+}
+
 void CSVParser::ParseFromCSV(const std::string &filename) {
+  m_source_file = filename;
+  m_from_snapshot = false;
+  m_source_stamp = CSVUtils::FileOperations::StampFile(filename);
+  std::chrono::nanoseconds open{0};
+  if (m_snapshot_enabled) {
+    std::optional<FileManager> fileManager;
+    {
+      PhaseTimer timer(open);
+      fileManager.emplace(m_source_file);
+    }
+    if (m_parser->LoadSnapshot(
+            CSVUtils::FileOperations::SnapshotPath(m_source_file),
+            fileManager->CreateFileHandler(m_io_mode),
+            fileManager->GetFileSize(), m_source_stamp)) {
+      m_parser->RecordOpen(open, fileManager->GetFileSize());
+      m_from_snapshot = true;
+      return;
+    }
+  }
+  std::unique_ptr<FileManager> fileManager;
+  {
+    PhaseTimer timer(open);
+    fileManager = std::make_unique<FileManager>(m_source_file);
+  }
+  auto fileHandler = fileManager->CreateFileHandler(m_io_mode);
+  m_parser->ParseDataFromCSV(std::move(fileHandler), fileManager->GetFileSize());
+  m_parser->RecordOpen(open, fileManager->GetFileSize());
+}
+
+ParseStats CSVParser::GetParseStats() const noexcept {
+  return m_parser ? m_parser->GetStats() : ParseStats{};
+}
+
+bool CSVParser::IsSourceChanged() const noexcept {
+  if (m_source_file.empty())
+    return false;
+  // a file that is missing right now is most likely mid-save, not changed yet
+  auto stamp = CSVUtils::FileOperations::StampFile(m_source_file);
+  return stamp != FileStamp{} && stamp != m_source_stamp;
+}
+
+std::unique_ptr<CSVParser> CSVParser::CloneConfiguration() const {
+  auto parser = std::make_unique<CSVParser>();
+  parser->SetParser(m_parser_mode, m_parser_workers);
+  parser->m_parser->SetColumnNames(m_parser->GetSourceColumnNames());
+  if (m_parser->HasProjection())
+    parser->m_parser->SetProjection(m_parser->GetColumnNames());
+  parser->m_parser->SetTrailingColumnsAllowed(
+      m_parser->IsTrailingColumnsAllowed());
+  parser->m_io_mode = m_io_mode;
+  parser->m_snapshot_enabled = m_snapshot_enabled;
+  return parser;
+}
+
+TableDiff CSVParser::Reconcile(const CSVParser &previous) {
+  return m_parser->Reconcile(*previous.m_parser);
+}
+
+bool CSVParser::SaveSnapshot() const {
+  if (m_source_file.empty())
+    return false;
+  return m_parser->SaveSnapshot(
+      CSVUtils::FileOperations::SnapshotPath(m_source_file), m_source_stamp);
+}
+
+size_t CSVParser::StreamFromCSV(const std::string &filename,
+                                StreamBatchCallback on_batch,
+                                size_t chunksize) {
   auto fileManager = std::make_unique<FileManager>(filename);
-  auto fileHandler = fileManager->CreateFileHandler();
-  m_parser->ParseDataFromCSV(fileHandler, fileManager->GetFileSize());
+  auto fileHandler = fileManager->CreateFileHandler(IOMode::Stream);
+  return m_parser->StreamDataFromCSV(*fileHandler, chunksize, on_batch);
 }
 
 std::vector<std::string_view> CSVParser::GetColumnNames() const noexcept {
@@ -293,14 +1262,64 @@ std::vector<std::string_view> CSVParser::GetColumnNames() const noexcept {
 }
 
 std::vector<std::vector<std::string_view>>
-CSVParser::GetCSVData() const noexcept {
+CSVParser::GetCSVData() const {
   return m_parser->GetCSVData();
 }
 
+std::span<const std::string_view>
+CSVParser::GetColumnNamesView() const noexcept {
+  return m_parser->GetColumnNamesView();
+}
+
+const std::vector<std::vector<std::string_view>> &
+CSVParser::GetCSVDataView() const {
+  return m_parser->GetCSVDataView();
+}
+
+const ColumnStore &CSVParser::GetTable() const noexcept {
+  return m_parser->GetTable();
+}
+
 size_t CSVParser::GetDataSize() const noexcept {
   return m_parser->GetCSVDataSize();
 }
 
+void CSVParser::BuildKeyIndex(size_t column) {
+  m_parser->BuildKeyIndex(column);
+}
+
+size_t CSVParser::FindRow(std::string_view key) const noexcept {
+  return m_parser->FindRow(key);
+}
+
+bool CSVParser::HasKeyIndex() const noexcept { return m_parser->HasKeyIndex(); }
+
+ColumnStore::RowView CSVParser::GetRow(size_t row) const {
+  return m_parser->GetRow(row);
+}
+
+void CSVParser::BuildSecondaryIndex(std::string_view column) {
+  m_parser->BuildSecondaryIndex(m_parser->GetColumnIndex(column));
+}
+
+bool CSVParser::HasSecondaryIndex(std::string_view column) const {
+  return m_parser->HasSecondaryIndex(m_parser->GetColumnIndex(column));
+}
+
+std::vector<size_t> CSVParser::SelectRows(const RowQuery &query) const {
+  return m_parser->SelectRows(query);
+}
+
+std::vector<ColumnStore::RowView>
+CSVParser::Select(const RowQuery &query) const {
+  auto ids = SelectRows(query);
+  std::vector<ColumnStore::RowView> rows;
+  rows.reserve(ids.size());
+  for (size_t row : ids)
+    rows.push_back(m_parser->GetRow(row));
+  return rows;
+}
+
 void CSVParser::WriteToCSV(const std::string &filename) {
   m_parser->WriteToFile(filename);
 }
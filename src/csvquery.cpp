@@ -0,0 +1,194 @@
+#include "kits/csvparser.hpp"
+#include "kits/threadpool.hpp"
+
+#include <cmath>
+
+namespace {
+// rows filtered per task when Select has to scan; below this the scan stays on the calling thread
+constexpr size_t kScanBatchRows = 65536;
+} // namespace
+
+bool RowQuery::Predicate::Matches(std::string_view field) const noexcept {
+  if (op == Op::Equal)
+    return field == text;
+  double value;
+  if (!CSVUtils::TryParseNumber(field, value))
+    return false;
+  switch (op) {
+  case Op::Less:
+    return value < high;
+  case Op::LessEqual:
+    return value <= high;
+  case Op::Greater:
+    return value > low;
+  case Op::GreaterEqual:
+    return value >= low;
+  case Op::Between:
+    return value >= low && value <= high;
+  default:
+    return false;
+  }
+}
+
+RowQuery &RowQuery::Equal(std::string_view column, std::string_view value) {
+  m_predicates.push_back(Predicate{std::string(column), Op::Equal, std::string(value)});
+  return *this;
+}
+
+RowQuery &RowQuery::Between(std::string_view column, double low, double high) {
+  m_predicates.push_back(Predicate{std::string(column), Op::Between, {}, low, high});
+  return *this;
+}
+
+RowQuery &RowQuery::Bound(std::string_view column, Op op, double value) {
+  Predicate predicate{std::string(column), op, {}};
+  (op == Op::Less || op == Op::LessEqual ? predicate.high : predicate.low) = value;
+  m_predicates.push_back(std::move(predicate));
+  return *this;
+}
+
+void SecondaryIndex::Build(const ColumnStore &table, size_t column) {
+  auto fields = table.Column(column);
+  m_column = column;
+  m_groups.clear();
+  m_values.clear();
+  m_ordered.clear();
+
+  // counting pass, then rows are placed per group in ascending order
+  for (size_t row = 0; row < fields.size(); ++row) {
+    ++m_groups[fields[row]].second;
+  }
+  uint32_t offset = 0;
+  for (auto &[value, group] : m_groups) {
+    group.first = offset;
+    offset += group.second;
+    group.second = group.first;
+  }
+  m_grouped.resize(fields.size());
+  for (size_t row = 0; row < fields.size(); ++row) {
+    m_grouped[m_groups[fields[row]].second++] = static_cast<uint32_t>(row);
+  }
+
+  std::vector<std::pair<double, uint32_t>> numeric;
+  for (size_t row = 0; row < fields.size(); ++row) {
+    double value;
+    if (CSVUtils::TryParseNumber(fields[row], value) && !std::isnan(value))
+      numeric.emplace_back(value, static_cast<uint32_t>(row));
+  }
+  std::sort(numeric.begin(), numeric.end());
+  m_values.reserve(numeric.size());
+  m_ordered.reserve(numeric.size());
+  for (const auto &[value, row] : numeric) {
+    m_values.push_back(value);
+    m_ordered.push_back(row);
+  }
+}
+
+std::span<const uint32_t> SecondaryIndex::Equal(std::string_view value) const noexcept {
+  auto it = m_groups.find(value);
+  if (it == m_groups.end())
+    return {};
+  return std::span<const uint32_t>(m_grouped).subspan(it->second.first, it->second.second - it->second.first);
+}
+
+std::span<const uint32_t> SecondaryIndex::Range(const RowQuery::Predicate &predicate) const noexcept {
+  using Op = RowQuery::Op;
+  auto begin = m_values.begin();
+  auto end = m_values.end();
+  switch (predicate.op) {
+  case Op::Less:
+    end = std::lower_bound(m_values.begin(), m_values.end(), predicate.high);
+    break;
+  case Op::LessEqual:
+    end = std::upper_bound(m_values.begin(), m_values.end(), predicate.high);
+    break;
+  case Op::Greater:
+    begin = std::upper_bound(m_values.begin(), m_values.end(), predicate.low);
+    break;
+  case Op::GreaterEqual:
+    begin = std::lower_bound(m_values.begin(), m_values.end(), predicate.low);
+    break;
+  case Op::Between:
+    begin = std::lower_bound(m_values.begin(), m_values.end(), predicate.low);
+    end = std::upper_bound(m_values.begin(), m_values.end(), predicate.high);
+    break;
+  default:
+    return {};
+  }
+  if (begin >= end)
+    return {};
+  return std::span<const uint32_t>(m_ordered).subspan(begin - m_values.begin(), end - begin);
+}
+
+void ParserImpl::BuildSecondaryIndex(size_t column) {
+  if (column >= m_table.ColumnCount())
+    throw std::runtime_error("Invalid index column.");
+  PhaseTimer timer(m_stats.index);
+  m_secondary_indices[column].Build(m_table, column);
+}
+
+std::vector<size_t> ParserImpl::SelectRows(const RowQuery &query) const {
+  const auto &predicates = query.GetPredicates();
+  std::vector<size_t> columns;
+  for (const auto &predicate : predicates) {
+    columns.push_back(GetColumnIndex(predicate.column));
+    if (columns.back() >= m_table.ColumnCount())
+      throw std::runtime_error("Invalid query column: " + predicate.column);
+  }
+
+  // drive the query from the indexed predicate with the fewest candidate rows
+  size_t driver = predicates.size();
+  std::span<const uint32_t> candidates;
+  for (size_t i = 0; i < predicates.size(); ++i) {
+    auto index = m_secondary_indices.find(columns[i]);
+    if (index == m_secondary_indices.end())
+      continue;
+    auto rows = predicates[i].op == RowQuery::Op::Equal ? index->second.Equal(predicates[i].text)
+                                                        : index->second.Range(predicates[i]);
+    if (driver == predicates.size() || rows.size() < candidates.size()) {
+      driver = i;
+      candidates = rows;
+    }
+  }
+
+  auto MatchesAll = [&](size_t row) {
+    for (size_t i = 0; i < predicates.size(); ++i) {
+      if (i != driver && !predicates[i].Matches(m_table.Field(row, columns[i])))
+        return false;
+    }
+    return true;
+  };
+
+  std::vector<size_t> result;
+  if (driver != predicates.size()) {
+    for (uint32_t row : candidates) {
+      if (MatchesAll(row))
+        result.push_back(row);
+    }
+    // range candidates come in value order
+    if (predicates[driver].op != RowQuery::Op::Equal)
+      std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  const size_t rows = m_table.RowCount();
+  if (rows <= kScanBatchRows) {
+    for (size_t row = 0; row < rows; ++row) {
+      if (MatchesAll(row))
+        result.push_back(row);
+    }
+    return result;
+  }
+  std::vector<std::vector<size_t>> batches((rows + kScanBatchRows - 1) / kScanBatchRows);
+  ThreadPool::Shared().ParallelFor(rows, kScanBatchRows, [&](size_t begin, size_t end) {
+    auto &batch = batches[begin / kScanBatchRows];
+    for (size_t row = begin; row < end; ++row) {
+      if (MatchesAll(row))
+        batch.push_back(row);
+    }
+  });
+  for (const auto &batch : batches) {
+    result.insert(result.end(), batch.begin(), batch.end());
+  }
+  return result;
+}
@@ -0,0 +1,288 @@
+#include "kits/csvparser.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <random>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr char kSnapshotMagic[8] = {'C', 'S', 'V', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint32_t kSnapshotVersion = 3;
+
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t columns;
+  uint64_t column_names_hash;
+  uint64_t source_size;
+  int64_t source_mtime;
+  uint64_t source_hash;
+};
+
+uint64_t Mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+} // namespace
+
+namespace CSVUtils {
+inline namespace FileOperations {
+FileStamp StampFile(const std::string &filename) {
+  std::error_code ec;
+  FileStamp stamp;
+  stamp.size = std::filesystem::file_size(filename, ec);
+  if (ec)
+    return FileStamp{};
+  stamp.mtime = std::filesystem::last_write_time(filename, ec).time_since_epoch().count();
+  return ec ? FileStamp{} : stamp;
+}
+
+std::string SnapshotPath(const std::string &filename) { return filename + ".snap"; }
+
+std::string UniqueTempName(const std::string &filename) {
+#ifdef _WIN32
+  auto pid = _getpid();
+#else
+  auto pid = ::getpid();
+#endif
+  thread_local std::mt19937_64 random{std::random_device{}()};
+  return filename + "." + std::to_string(pid) + "." + std::to_string(random()) + ".tmp";
+}
+
+uint64_t HashBytes(std::string_view bytes) noexcept {
+  // four independent multiply-xorshift lanes over 32-byte blocks, folded at the end
+  uint64_t lanes[4] = {0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0x27D4EB2F165667C5ull};
+  const char *data = bytes.data();
+  size_t pos = 0;
+  for (; pos + 32 <= bytes.size(); pos += 32) {
+    for (size_t lane = 0; lane < 4; ++lane) {
+      uint64_t word;
+      std::memcpy(&word, data + pos + lane * 8, sizeof(word));
+      lanes[lane] = (lanes[lane] ^ word) * 0x9FB21C651E98DF25ull;
+      lanes[lane] ^= lanes[lane] >> 29;
+    }
+  }
+  uint64_t hash = bytes.size();
+  for (auto lane : lanes) {
+    hash = Mix(hash ^ lane);
+  }
+  for (; pos < bytes.size(); ++pos) {
+    hash = (hash ^ static_cast<unsigned char>(data[pos])) * 1099511628211ull;
+  }
+  return Mix(hash);
+}
+}; // namespace FileOperations
+}; // namespace CSVUtils
+
+void ColumnStore::Save(ByteWriter &out) const {
+  out.Put<uint64_t>(m_row_count);
+  out.Put<uint64_t>(m_columns.size());
+  for (const auto &column : m_columns) {
+    out.PutArray(column);
+  }
+}
+
+void ColumnStore::Load(ByteReader &in, std::string_view source) {
+  Reset(source);
+  m_row_count = in.Get<uint64_t>();
+  m_columns.resize(in.Get<uint64_t>());
+  for (auto &column : m_columns) {
+    in.GetArray(column);
+    if (column.size() != m_row_count)
+      throw std::runtime_error("Corrupted snapshot.");
+    for (const auto &span : column) {
+      if (span.IsValid() && uint64_t{span.offset} + span.length > source.size())
+        throw std::runtime_error("Corrupted snapshot.");
+    }
+  }
+}
+
+void KeyIndex::Save(ByteWriter &out) const {
+  out.Put<uint8_t>(IsBuilt());
+  if (!IsBuilt())
+    return;
+  out.Put<uint64_t>(m_column);
+  out.Put<uint64_t>(m_size);
+  out.PutArray(m_slots);
+}
+
+void KeyIndex::Load(ByteReader &in, const ColumnStore &table) {
+  Clear();
+  if (!in.Get<uint8_t>())
+    return;
+  m_column = in.Get<uint64_t>();
+  m_size = in.Get<uint64_t>();
+  in.GetArray(m_slots);
+  bool powerOfTwo = !m_slots.empty() && (m_slots.size() & (m_slots.size() - 1)) == 0;
+  if (m_column >= table.ColumnCount() || !powerOfTwo || m_size >= m_slots.size())
+    throw std::runtime_error("Corrupted snapshot.");
+  for (auto entry : m_slots) {
+    if (entry != 0 && ((entry & 0xFFFFFFFFu) == 0 || (entry & 0xFFFFFFFFu) > table.RowCount()))
+      throw std::runtime_error("Corrupted snapshot.");
+  }
+  m_table = &table;
+}
+
+uint64_t ParserImpl::ColumnNamesHash() const noexcept {
+  uint64_t hash = m_source_col_names.size();
+  for (auto name : m_source_col_names) {
+    hash = Mix(hash ^ KeyIndex::Hash(name));
+  }
+  // a projection stores other columns from the same file
+  for (auto column : m_projection) {
+    hash = Mix(hash ^ (column + 1));
+  }
+  // so does a layout with undeclared trailing columns
+  return m_trailing_columns ? Mix(hash ^ 0x7472) : hash;
+}
+
+bool ParserImpl::SaveSnapshot(const std::string &snapshot, const FileStamp &stamp) const {
+  if (m_buffer.empty() || m_edited)
+    return false;
+  std::string temp;
+  try {
+    ByteWriter out;
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.columns = static_cast<uint32_t>(m_col_names.size());
+    header.column_names_hash = ColumnNamesHash();
+    header.source_size = m_buffer.size();
+    header.source_mtime = stamp.mtime;
+    header.source_hash = CSVUtils::FileOperations::HashBytes(m_buffer);
+    if (stamp.size != header.source_size)
+      return false;
+    out.Put(header);
+
+    std::vector<FieldSpan> rows(m_rows.size());
+    for (size_t i = 0; i < m_rows.size(); ++i) {
+      rows[i] = FieldSpan{static_cast<uint32_t>(m_rows[i].data() - m_buffer.data()),
+                          static_cast<uint32_t>(m_rows[i].size())};
+    }
+    out.PutArray(rows);
+    m_table.Save(out);
+    m_key_index.Save(out);
+    {
+      std::lock_guard<std::mutex> lock(m_typed_mutex);
+      out.Put<uint64_t>(m_real_columns.size());
+      for (const auto &[key, column] : m_real_columns) {
+        out.Put<uint64_t>(key.first);
+        out.Put<char>(key.second);
+        column.Save(out);
+      }
+      out.Put<uint64_t>(m_index_columns.size());
+      for (const auto &[key, column] : m_index_columns) {
+        out.Put<uint64_t>(key.first);
+        out.Put<char>(key.second);
+        column.Save(out);
+      }
+    }
+
+    // write aside and rename so a reader never maps a half-written snapshot
+    temp = CSVUtils::FileOperations::UniqueTempName(snapshot);
+    {
+      std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+      if (!file.is_open())
+        return false;
+      file.write(out.Data().data(), static_cast<std::streamsize>(out.Data().size()));
+      file.close();
+      if (!file) {
+        std::filesystem::remove(temp);
+        return false;
+      }
+    }
+    std::filesystem::rename(temp, snapshot);
+    return true;
+  } catch (const std::exception &) {
+    if (!temp.empty()) {
+      std::error_code ignored;
+      std::filesystem::remove(temp, ignored);
+    }
+    return false;
+  }
+}
+
+bool ParserImpl::LoadSnapshot(const std::string &snapshot, std::unique_ptr<BaseIO> source, size_t filesize,
+                              const FileStamp &stamp) {
+  try {
+    if (!std::filesystem::exists(snapshot))
+      return false;
+    MMapIO mapped(snapshot);
+    ByteReader in(mapped.View());
+    auto header = in.Get<SnapshotHeader>();
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+        header.version != kSnapshotVersion || header.columns != m_col_names.size() ||
+        header.column_names_hash != ColumnNamesHash() || header.source_size != stamp.size ||
+        header.source_mtime != stamp.mtime)
+      return false;
+
+    ResetParsedState();
+    LoadBuffer(std::move(source), filesize);
+    bool valid;
+    {
+      PhaseTimer timer(m_stats.validate);
+      valid = m_buffer.size() == header.source_size &&
+              CSVUtils::FileOperations::HashBytes(m_buffer) == header.source_hash;
+    }
+    if (!valid) {
+      ResetParsedState();
+      return false;
+    }
+
+    {
+      PhaseTimer timer(m_stats.split_rows);
+      std::vector<FieldSpan> rows;
+      in.GetArray(rows);
+      m_rows.reserve(rows.size());
+      for (const auto &row : rows) {
+        if (uint64_t{row.offset} + row.length > m_buffer.size())
+          throw std::runtime_error("Corrupted snapshot.");
+        m_rows.push_back(m_buffer.substr(row.offset, row.length));
+      }
+    }
+    {
+      PhaseTimer timer(m_stats.split_columns);
+      m_table.Load(in, m_buffer);
+    }
+    {
+      PhaseTimer timer(m_stats.index);
+      m_key_index.Load(in, m_table);
+    }
+    // typed columns were converted from this very text, so they are taken as they are
+    for (auto count = in.Get<uint64_t>(); count > 0; --count) {
+      auto column = in.Get<uint64_t>();
+      auto delim = in.Get<char>();
+      if (column >= m_table.ColumnCount())
+        throw std::runtime_error("Corrupted snapshot.");
+      auto &typed = m_real_columns[{column, delim}];
+      typed.Load(in);
+      if (typed.size() != m_table.RowCount())
+        throw std::runtime_error("Corrupted snapshot.");
+    }
+    for (auto count = in.Get<uint64_t>(); count > 0; --count) {
+      auto column = in.Get<uint64_t>();
+      auto delim = in.Get<char>();
+      if (column >= m_table.ColumnCount())
+        throw std::runtime_error("Corrupted snapshot.");
+      auto &typed = m_index_columns[{column, delim}];
+      typed.Load(in);
+      if (typed.size() != m_table.RowCount())
+        throw std::runtime_error("Corrupted snapshot.");
+    }
+    m_stats.from_snapshot = true;
+    return true;
+  } catch (const std::exception &) {
+    // a bad snapshot only costs a regular parse
+    ResetParsedState();
+    return false;
+  }
+}
@@ -0,0 +1,60 @@
+#include "kits/intern.hpp"
+
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+InternedString StringArena::Intern(std::string_view text) {
+  {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    if (auto it = m_index.find(text); it != m_index.end())
+      return it->second;
+  }
+  std::unique_lock<std::shared_mutex> lock(m_mutex);
+  // another thread may have interned it between the two locks
+  if (auto it = m_index.find(text); it != m_index.end())
+    return it->second;
+  if (text.size() >= InternedString::npos || m_index.size() >= InternedString::npos)
+    throw std::runtime_error("String arena is full.");
+  const char *data = Store(text);
+  InternedString handle(data, static_cast<uint32_t>(text.size()), static_cast<uint32_t>(m_index.size()));
+  m_index.emplace(handle.View(), handle);
+  return handle;
+}
+
+InternedString StringArena::Find(std::string_view text) const {
+  std::shared_lock<std::shared_mutex> lock(m_mutex);
+  auto it = m_index.find(text);
+  return it == m_index.end() ? InternedString() : it->second;
+}
+
+size_t StringArena::size() const {
+  std::shared_lock<std::shared_mutex> lock(m_mutex);
+  return m_index.size();
+}
+
+size_t StringArena::GetByteSize() const {
+  std::shared_lock<std::shared_mutex> lock(m_mutex);
+  return m_bytes;
+}
+
+const char *StringArena::Store(std::string_view text) {
+  if (text.empty())
+    return "";
+  m_bytes += text.size();
+  // long strings get a block of their own instead of wasting the tail of the current one
+  if (text.size() > kBlockSize / 4) {
+    m_blocks.push_back(std::make_unique<char[]>(text.size()));
+    std::memcpy(m_blocks.back().get(), text.data(), text.size());
+    return m_blocks.back().get();
+  }
+  if (!m_block || m_block_used + text.size() > kBlockSize) {
+    m_blocks.push_back(std::make_unique<char[]>(kBlockSize));
+    m_block = m_blocks.back().get();
+    m_block_used = 0;
+  }
+  char *data = m_block + m_block_used;
+  std::memcpy(data, text.data(), text.size());
+  m_block_used += text.size();
+  return data;
+}
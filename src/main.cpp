@@ -1,6 +1,6 @@
 #include <iostream>
 
-#include "impl/FreqListInner.h"
+#include "impl/FreqTable.h"
 #include "impl/RFConfigManager.h"
 #include "kits/csvparser.hpp"
 #include "stim/RFModule.hpp"
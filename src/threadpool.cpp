@@ -0,0 +1,140 @@
+#include "kits/threadpool.hpp"
+
+#include <algorithm>
+
+namespace {
+// pool and queue the current thread works for, so pushes from a task land in its own deque
+thread_local const ThreadPool *t_pool = nullptr;
+thread_local size_t t_queue = 0;
+} // namespace
+
+ThreadPool::ThreadPool(size_t workers) {
+  workers = std::max<size_t>(workers, 1);
+  for (size_t i = 0; i < workers; ++i) {
+    m_queues.emplace_back(std::make_unique<WorkQueue>());
+  }
+  for (size_t i = 0; i < workers; ++i) {
+    m_threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_wake_mutex);
+    m_stop = true;
+  }
+  m_wake.notify_all();
+  for (auto &thread : m_threads) {
+    thread.join();
+  }
+}
+
+ThreadPool &ThreadPool::Shared() {
+  static ThreadPool pool;
+  return pool;
+}
+
+void ThreadPool::Push(Task task) {
+  size_t index = (t_pool == this) ? t_queue : m_next_queue.fetch_add(1) % m_queues.size();
+  {
+    std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+    m_queues[index]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_wake_mutex);
+    m_pending.fetch_add(1);
+  }
+  m_wake.notify_one();
+}
+
+bool ThreadPool::TryRunOne() {
+  Task task;
+  size_t home = (t_pool == this) ? t_queue : 0;
+  for (size_t i = 0; i < m_queues.size() && !task; ++i) {
+    auto &queue = *m_queues[(home + i) % m_queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+      continue;
+    // newest own work first for locality, oldest (largest remaining) work when stealing
+    if (i == 0 && t_pool == this) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    } else {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+  }
+  if (!task)
+    return false;
+  m_pending.fetch_sub(1);
+  task();
+  return true;
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+  t_pool = this;
+  t_queue = index;
+  while (true) {
+    if (TryRunOne())
+      continue;
+    std::unique_lock<std::mutex> lock(m_wake_mutex);
+    m_wake.wait(lock, [this] { return m_stop || m_pending.load() > 0; });
+    if (m_stop)
+      return;
+  }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, const RangeTask &fn) {
+  if (count == 0)
+    return;
+  grain = std::max<size_t>(grain, 1);
+  const size_t chunks = (count + grain - 1) / grain;
+  if (chunks == 1) {
+    fn(0, count);
+    return;
+  }
+
+  struct Group {
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> remaining;
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+  auto group = std::make_shared<Group>();
+  group->remaining.store(chunks);
+
+  // Runs chunks of this loop until all are claimed. `fn` is only touched after a successful claim, so a
+  // runner that starts after ParallelFor returned finds nothing left and never sees a dangling `fn`.
+  auto run = [group, &fn, count, grain, chunks] {
+    for (size_t chunk; (chunk = group->next.fetch_add(1)) < chunks;) {
+      if (!group->failed.load()) {
+        try {
+          size_t begin = chunk * grain;
+          fn(begin, std::min(count, begin + grain));
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(group->mutex);
+          if (!group->error)
+            group->error = std::current_exception();
+          group->failed.store(true);
+        }
+      }
+      if (group->remaining.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(group->mutex);
+        group->done.notify_all();
+      }
+    }
+  };
+  for (size_t runner = std::min(chunks - 1, m_queues.size()); runner > 0; --runner) {
+    Push(run);
+  }
+
+  // The caller claims chunks too and then only waits for the ones other threads are running. It never
+  // runs foreign tasks: one could need a lock the caller holds, or wait on a loop further down its stack.
+  run();
+  std::unique_lock<std::mutex> lock(group->mutex);
+  group->done.wait(lock, [&group] { return group->remaining.load() == 0; });
+  if (group->error)
+    std::rethrow_exception(group->error);
+}